@@ -69,6 +69,24 @@ constexpr Bitboard shift(Bitboard B)
 	return 0;
 }
 
+/// Extends every square of `B` to the edge of the board. Only `NORTH` and `SOUTH` are supported.
+template<Direction D>
+constexpr Bitboard fill(Bitboard B)
+{
+	static_assert(D == NORTH || D == SOUTH);
+	if (D == NORTH) {
+		B |= B << 8;
+		B |= B << 16;
+		B |= B << 32;
+	}
+	else {
+		B |= B >> 8;
+		B |= B >> 16;
+		B |= B >> 32;
+	}
+	return B;
+}
+
 //static const uint64_t reversed_double_bytes[65536] =
 //{
 //	#define two14 (1 << 14)
@@ -38,6 +38,23 @@ constexpr int PIECE_COUNT = 7;
 constexpr Piece EMPTY = 0, PAWN = 1, KNIGHT = 2, BISHOP = 3, ROOK = 4, QUEEN = 5, KING = 6;
 
 
+/// A middlegame score and an endgame score packed into one integer, so that both phases are looked up, added and subtracted in one operation. The endgame score is stored in the upper 16 bits. A negative middlegame score borrows from it, which `endgame_score` undoes.
+typedef int32_t Score;
+
+constexpr Score make_score(int middlegame, int endgame)
+{
+	return (Score)((uint32_t)endgame << 16) + middlegame;
+}
+inline int middlegame_score(Score score)
+{
+	return (int16_t)(uint16_t)score;
+}
+inline int endgame_score(Score score)
+{
+	return (int16_t)(uint16_t)((uint32_t)(score + 0x8000) >> 16);
+}
+
+
 typedef short CastlingRights;
 constexpr CastlingRights CASTLE_KINGSIDE[2] = {1 << WHITE, 1 << BLACK};
 constexpr CastlingRights CASTLE_QUEENSIDE[2] = {4 << WHITE, 4 << BLACK};
@@ -122,6 +139,11 @@ inline bool is_irreversible(Move move)
 {
 	return move_captured_piece(move) || move_piece(move) == PAWN;
 }
+/// Returns whether `move` is neither a capture nor a promotion.
+inline bool is_quiet(Move move)
+{
+	return !move_captured_piece(move) && move_promotion(move) == move_piece(move);
+}
 
 
 typedef int Direction;
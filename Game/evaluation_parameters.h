@@ -0,0 +1,156 @@
+//
+//  evaluation_parameters.h
+//  Chaos Chess (Hummingbird)
+//
+//  Generated by Tuner::write_parameters. The values can be edited by hand, but running the tuner rewrites the whole file.
+//
+
+#pragma once
+#ifndef evaluation_parameters_h
+#define evaluation_parameters_h
+
+#include "definitions.h"
+
+namespace Magic
+{
+
+/// Usage: `MATERIAL_SCORES_MIDDLEGAME[piece]`.
+constexpr int MATERIAL_SCORES_MIDDLEGAME[PIECE_COUNT] =
+{
+	0, 90, 290, 300, 500, 900, 0
+};
+
+/// Usage: `MATERIAL_SCORES_ENDGAME[piece]`.
+constexpr int MATERIAL_SCORES_ENDGAME[PIECE_COUNT] =
+{
+	0, 120, 250, 310, 540, 940, 0
+};
+
+/// Scores for white's pawns on each square, as seen with white at the bottom of the board; black's are mirrored. Added to the material score in both phases.
+constexpr int PAWN_SCORES[64] =
+{
+	  0,   0,   0,   0,   0,   0,   0,   0,
+	 40,  40,  40,  40,  40,  40,  40,  40,
+	 30,  30,  30,  35,  35,  30,  30,  30,
+	 15,  20,  20,  30,  30,  20,  20,  15,
+	  5,   5,  10,  30,  30,  10,   5,   5,
+	  0,   5,  -5, -10, -10,  -5,   5,   0,
+	  0,   0,   0, -10, -10,   0,   0,   0,
+	  0,   0,   0,   0,   0,   0,   0,   0,
+};
+
+/// Scores for white's knights on each square, as seen with white at the bottom of the board; black's are mirrored. Added to the material score in both phases.
+constexpr int KNIGHT_SCORES[64] =
+{
+	-30, -25, -20, -20, -20, -20, -25, -30,
+	-25,   0,   0,   0,   0,   0,   0, -25,
+	-20,   0,   0,   5,   5,   0,   0, -20,
+	-20,   0,   5,  15,  15,   5,   0, -20,
+	-20,   5,   5,  15,  15,   5,   5, -20,
+	-20,   0,   5,   0,   0,   5,   0, -20,
+	-25,   0,   0,   0,   0,   0,   0, -25,
+	-30, -10, -20, -20, -20, -20, -10, -30,
+};
+
+/// Scores for white's bishops on each square, as seen with white at the bottom of the board; black's are mirrored. Added to the material score in both phases.
+constexpr int BISHOP_SCORES[64] =
+{
+	 -5,  -5,  -5,  -5,  -5,  -5,  -5,  -5,
+	 -5,   0,   0,   0,   0,   0,   0,  -5,
+	 -5,   0,   0,   0,   0,   0,   0,  -5,
+	 -5,   5,   0,   5,   5,   0,   5,  -5,
+	 -5,   0,  10,   5,   5,  10,   0,  -5,
+	 -5,   0,   0,   0,   0,   0,   0,  -5,
+	 -5,  20,   0,   0,   0,   0,  20,  -5,
+	 -5,  -5,  -5,  -5,  -5,  -5,  -5,  -5,
+};
+
+/// Scores for white's rooks on each square, as seen with white at the bottom of the board; black's are mirrored. Added to the material score in both phases.
+constexpr int ROOK_SCORES[64] =
+{
+	  0,   0,   0,   0,   0,   0,   0,   0,
+	 10,  10,  10,  15,  15,  10,  10,  10,
+	-10,   0,   0,   0,   0,   0,   0, -10,
+	-10,   0,   0,   0,   0,   0,   0, -10,
+	-10,   0,   0,   0,   0,   0,   0, -10,
+	-10,   0,   0,   0,   0,   0,   0, -10,
+	-10,   0,   0,   0,   0,   0,   0, -10,
+	  0,   0,   0,  15,  15,   0,   0,   0,
+};
+
+/// Scores for white's queens on each square, as seen with white at the bottom of the board; black's are mirrored. Added to the material score in both phases.
+constexpr int QUEEN_SCORES[64] =
+{
+	-10,  -5,  -5,  -5,  -5,  -5,  -5, -10,
+	 -5,   0,   0,   0,   0,   0,   0,  -5,
+	 -5,   0,   0,   5,   5,   0,   0,  -5,
+	 -5,   0,   5,   5,   5,   5,   0,  -5,
+	 -5,   0,   5,   5,   5,   5,   0,  -5,
+	 -5,   0,   0,   5,   5,   0,   0,  -5,
+	 -5,   0,   0,  10,  10,   0,   0,  -5,
+	-10,  -5,  -5,  -5,  -5,  -5,  -5, -10,
+};
+
+/// Like `PAWN_SCORES`, but for the king in the middlegame only.
+constexpr int KING_SCORES_MIDDLEGAME[64] =
+{
+	-30, -30, -35, -35, -35, -35, -30, -30,
+	-25, -25, -30, -30, -30, -30, -25, -25,
+	-20, -20, -25, -25, -25, -25, -20, -20,
+	-15, -15, -20, -20, -20, -20, -15, -15,
+	-10, -10, -15, -15, -15, -15, -10, -10,
+	 -5,  -5, -10, -10, -10, -10,  -5,  -5,
+	  0,   0,   0,   0,   0,   0,   0,   0,
+	 10,  50,  70,   0,   0,   5,  70,  40,
+};
+
+/// Like `PAWN_SCORES`, but for the king in the endgame only.
+constexpr int KING_SCORES_ENDGAME[64] =
+{
+	-20, -10,  -5,  -5,  -5,  -5, -10, -20,
+	-10,   0,   0,   0,   0,   0,   0, -10,
+	  0,  25,  30,  30,  30,  30,  25,   0,
+	  0,  20,  30,  40,  40,  30,  20,   0,
+	  5,   5,  30,  40,  40,  30,   5,   5,
+	-10,   5,  20,  30,  30,  20,   5, -10,
+	-30, -15,   0,   0,   0,   0, -15, -30,
+	-40, -30, -15,  -5,  -5, -15, -30, -40,
+};
+
+/// Applies to a player with at least two bishops.
+constexpr int BISHOP_PAIR_SCORE = 30;
+
+/// Applies to each safe square that a piece can move to. See `AttackMaps::mobility`.
+constexpr int MOBILITY_SCORE = 4;
+
+/// Usage: `ATTACKED_PIECE_SCORES[piece]`. Applies to each piece that the opponent attacks.
+constexpr int ATTACKED_PIECE_SCORES[PIECE_COUNT] =
+{
+	0, -8, -40, -40, -80, -120, -220
+};
+
+/// Applies to each castling right that a player still has.
+constexpr int CASTLING_RIGHT_SCORE = 20;
+
+/// Usage: `PASSED_PAWN_SCORES[endgame][rank]`, where `rank` counts from the pawn owner's side of the board.
+constexpr int PASSED_PAWN_SCORES[2][8] =
+{
+	{0, 5, 5, 10, 20, 35, 60, 0},
+	{0, 10, 15, 25, 40, 65, 100, 0},
+};
+
+/// Usage: `DOUBLED_PAWN_SCORE[endgame]`. Applies to each pawn that has a friendly pawn in front of it.
+constexpr int DOUBLED_PAWN_SCORE[2] = {-10, -20};
+
+/// Usage: `ISOLATED_PAWN_SCORE[endgame]`. Applies to each pawn with no friendly pawns on the adjacent files.
+constexpr int ISOLATED_PAWN_SCORE[2] = {-10, -15};
+
+/// Usage: `DEFENDED_PAWN_SCORE[endgame]`. Applies to each pawn that a friendly pawn defends.
+constexpr int DEFENDED_PAWN_SCORE[2] = {5, 8};
+
+/// Applies to each knight on an outpost square that a friendly pawn defends and no enemy pawn can ever attack.
+constexpr int KNIGHT_OUTPOST_SCORE = 20;
+
+} // namespace Magic
+
+#endif /* evaluation_parameters_h */
@@ -17,6 +17,7 @@ Game<V>::Game()
 	castling_rights_history.reserve(foreseeable_future);
 	EN_PASSANT_HISTORY.reserve(foreseeable_future);
 	hash_history.reserve(foreseeable_future);
+	pawn_hash_history.reserve(foreseeable_future);
 	reversible_move_clock_history.reserve(foreseeable_future);
 	if constexpr (Variants::has_destructive_moves(V)) {
 		// These vectors will only be appended to when a destructive move is played
@@ -73,13 +74,20 @@ void Game<V>::clear()
 	move_history.clear();
 	castling_rights_history.clear();
 	EN_PASSANT_HISTORY.clear();
+	hash_history.clear();
+	pawn_hash_history.clear();
 	reversible_move_clock_history.clear();
+	piece_scores_history.clear();
 	
 //	repetition_count.clear();
 //	repetition_count_current = 0;
 	reversible_move_clock = 0;
 	
 	hash = 0;
+	pawn_hash = 0;
+	piece_scores = PieceScores();
+	invalidate_attack_maps();
+	accumulators.assign(1, NNUE::Accumulator());
 }
 
 template<Variant V>
@@ -90,6 +98,12 @@ void Game<V>::set(int square, Piece piece, Color player)
 	PLAYERS[player] |= S;
 	OCCUPIED |= S;
 	list[square] = piece;
+	invalidate_attack_maps();
+	// The accumulator is computed from scratch the next time it's needed
+	if (accumulators.size() <= move_history.size())
+		accumulators.resize(move_history.size() + 1);
+	accumulators[move_history.size()].network = nullptr;
+	add_piece_scores(square, piece, player);
 }
 
 template<Variant V>
@@ -259,6 +273,7 @@ template<Variant V>
 void Game<V>::sync_hash()
 {
 	hash = 0;
+	pawn_hash = 0;
 	
 	// Board
 	for (int square = 0; square < 64; square++) {
@@ -268,6 +283,8 @@ void Game<V>::sync_hash()
 				if (PIECES[piece] & PLAYERS[player] & S)
 					hash ^= Zobrist::keys[square][player][piece];
 			}
+			if (PIECES[PAWN] & PLAYERS[player] & S)
+				pawn_hash ^= Zobrist::keys[square][player][PAWN];
 		}
 	}
 	
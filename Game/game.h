@@ -250,6 +250,14 @@ template<Variant V>
 inline std::vector<Move> Game<V>::legal_moves()
 {
 	std::vector<Move> moves;
+	legal_moves(moves);
+	return moves;
+}
+
+template<Variant V>
+inline void Game<V>::legal_moves(std::vector<Move> &moves)
+{
+	moves.clear();
 	generate_quasilegal_moves();
 	moves.reserve(quasilegal_moves.size());
 	
@@ -265,7 +273,7 @@ inline std::vector<Move> Game<V>::legal_moves()
 			}
 		}
 		if (has_legal_capture)
-			return moves;
+			return;
 		// Add the non-capture moves
 		for (Move move : quasilegal_moves) {
 			if (move_captured_piece(move) == EMPTY && attempt(move)) {
@@ -277,22 +285,21 @@ inline std::vector<Move> Game<V>::legal_moves()
 	
 	// Forced check
 	else if constexpr (Variants::has_forced_check_enabled(V)) {
-		bool has_check = false;
-		std::vector<Move> check_moves;
-		check_moves.reserve(8);
+		// Keep the check moves at the front of `moves`, in the order they were generated
+		size_t check_count = 0;
 		for (Move move : quasilegal_moves) {
 			if (attempt(move)) {
+				moves.push_back(move);
 				// If this is a check move
 				if (is_check(active_player)) {
-					has_check = true;
-					check_moves.push_back(move);
+					std::swap(moves[check_count], moves.back());
+					check_count++;
 				}
-				moves.push_back(move);
 				undo();
 			}
 		}
-		if (has_check)
-			return check_moves;
+		if (check_count)
+			moves.resize(check_count);
 	}
 	
 	// No special rules
@@ -304,13 +311,15 @@ inline std::vector<Move> Game<V>::legal_moves()
 			}
 		}
 	}
-	return moves;
 }
 
 template<Variant V>
 template<Color PLAYER>
 inline Bitboard Game<V>::attacked_squares() const
 {
+	if (attack_maps_are_valid[PLAYER] && attack_maps_hash[PLAYER] == hash)
+		return attack_maps_cache[PLAYER].ALL;
+	
 	constexpr Direction FORWARD_EAST = (PLAYER == WHITE ? NORTH_EAST : SOUTH_EAST);
 	constexpr Direction FORWARD_WEST = (PLAYER == WHITE ? NORTH_WEST : SOUTH_WEST);
 	
@@ -353,6 +362,136 @@ inline Bitboard Game<V>::attacked_squares() const
 	return ATTACKED;
 }
 
+template<Variant V>
+template<Color PLAYER>
+inline Bitboard Game<V>::king_attackers() const
+{
+	if (attack_maps_are_valid[PLAYER] && attack_maps_hash[PLAYER] == hash)
+		return attack_maps_cache[PLAYER].KING_ATTACKERS;
+	
+	constexpr Direction BACKWARD_EAST = (PLAYER == WHITE ? SOUTH_EAST : NORTH_EAST);
+	constexpr Direction BACKWARD_WEST = (PLAYER == WHITE ? SOUTH_WEST : NORTH_WEST);
+	
+	const Bitboard PAWNS = PIECES[PAWN] & PLAYERS[PLAYER];
+	const Bitboard KNIGHTS = PIECES[KNIGHT] & PLAYERS[PLAYER];
+	const Bitboard DIAGONAL_SLIDERS = (PIECES[BISHOP] | PIECES[QUEEN]) & PLAYERS[PLAYER];
+	const Bitboard STRAIGHT_SLIDERS = (PIECES[ROOK] | PIECES[QUEEN]) & PLAYERS[PLAYER];
+	const Bitboard KINGS = PIECES[KING] & PLAYERS[PLAYER];
+	
+	Bitboard ATTACKERS = 0;
+	Bitboard ENEMY_KINGS = PIECES[KING] & PLAYERS[!PLAYER];
+	while (ENEMY_KINGS) {
+		const int square = pop_lsb(ENEMY_KINGS);
+		const Bitboard S = square_to_bitboard(square);
+		ATTACKERS |= (shift<BACKWARD_EAST>(S) | shift<BACKWARD_WEST>(S)) & PAWNS;
+		ATTACKERS |= knight_span(square) & KNIGHTS;
+		ATTACKERS |= diagonal_span(square) & DIAGONAL_SLIDERS;
+		ATTACKERS |= horizontal_vertical_span(square) & STRAIGHT_SLIDERS;
+		ATTACKERS |= king_span(square) & KINGS;
+	}
+	return ATTACKERS;
+}
+
+template<Variant V>
+template<Color PLAYER>
+inline const AttackMaps &Game<V>::attack_maps() const
+{
+	if (!attack_maps_are_valid[PLAYER] || attack_maps_hash[PLAYER] != hash) {
+		compute_attack_maps<PLAYER>(attack_maps_cache[PLAYER]);
+		attack_maps_hash[PLAYER] = hash;
+		attack_maps_are_valid[PLAYER] = true;
+	}
+	return attack_maps_cache[PLAYER];
+}
+
+template<Variant V>
+template<Color PLAYER>
+inline void Game<V>::compute_attack_maps(AttackMaps &maps) const
+{
+	constexpr Color OPPONENT = !PLAYER;
+	constexpr Direction FORWARD = (PLAYER == WHITE ? NORTH : SOUTH);
+	constexpr Direction FORWARD_EAST = (PLAYER == WHITE ? NORTH_EAST : SOUTH_EAST);
+	constexpr Direction FORWARD_WEST = (PLAYER == WHITE ? NORTH_WEST : SOUTH_WEST);
+	constexpr Direction BACKWARD_EAST = (PLAYER == WHITE ? SOUTH_EAST : NORTH_EAST);
+	constexpr Direction BACKWARD_WEST = (PLAYER == WHITE ? SOUTH_WEST : NORTH_WEST);
+	
+	const Bitboard ENEMY_PAWNS = PIECES[PAWN] & PLAYERS[OPPONENT];
+	const Bitboard ENEMY_PAWN_ATTACKS = shift<BACKWARD_EAST>(ENEMY_PAWNS) | shift<BACKWARD_WEST>(ENEMY_PAWNS);
+	
+	Bitboard TARGETS;
+	if constexpr (Variants::has_friendly_fire_enabled(V))
+		TARGETS = ~(PIECES[KING] & PLAYERS[PLAYER]);
+	else
+		TARGETS = ~PLAYERS[PLAYER];
+	const Bitboard SAFE = TARGETS & ~ENEMY_PAWN_ATTACKS;
+	
+	int mobility = 0;
+	
+	// Pawns
+	const Bitboard PAWNS = PIECES[PAWN] & PLAYERS[PLAYER];
+	maps.BY_PIECE[PAWN] = shift<FORWARD_EAST>(PAWNS) | shift<FORWARD_WEST>(PAWNS);
+	const Bitboard PUSHES = shift<FORWARD>(PAWNS) & ~OCCUPIED;
+	mobility += popcount(PUSHES) + popcount(shift<FORWARD>(PUSHES) & ~OCCUPIED & Magic::MIDDLE_RANK[PLAYER]);
+	mobility += popcount(maps.BY_PIECE[PAWN] & OCCUPIED & TARGETS);
+	
+	// Knights
+	const Bitboard KNIGHTS = PIECES[KNIGHT] & PLAYERS[PLAYER];
+	maps.BY_PIECE[KNIGHT] = 0;
+	for (Bitboard N = KNIGHTS; N; ) {
+		const Bitboard SPAN = knight_span(pop_lsb(N));
+		maps.BY_PIECE[KNIGHT] |= SPAN;
+		mobility += popcount(SPAN & SAFE);
+	}
+	
+	// Bishops
+	const Bitboard BISHOPS = PIECES[BISHOP] & PLAYERS[PLAYER];
+	maps.BY_PIECE[BISHOP] = 0;
+	for (Bitboard B = BISHOPS; B; ) {
+		const Bitboard SPAN = diagonal_span(pop_lsb(B));
+		maps.BY_PIECE[BISHOP] |= SPAN;
+		mobility += popcount(SPAN & SAFE);
+	}
+	
+	// Rooks
+	const Bitboard ROOKS = PIECES[ROOK] & PLAYERS[PLAYER];
+	maps.BY_PIECE[ROOK] = 0;
+	for (Bitboard R = ROOKS; R; ) {
+		const Bitboard SPAN = horizontal_vertical_span(pop_lsb(R));
+		maps.BY_PIECE[ROOK] |= SPAN;
+		mobility += popcount(SPAN & SAFE);
+	}
+	
+	// Queens
+	const Bitboard QUEENS = PIECES[QUEEN] & PLAYERS[PLAYER];
+	maps.BY_PIECE[QUEEN] = 0;
+	for (Bitboard Q = QUEENS; Q; ) {
+		const int square = pop_lsb(Q);
+		const Bitboard SPAN = diagonal_span(square) | horizontal_vertical_span(square);
+		maps.BY_PIECE[QUEEN] |= SPAN;
+		mobility += popcount(SPAN & SAFE);
+	}
+	
+	// Kings
+	const Bitboard KINGS = PIECES[KING] & PLAYERS[PLAYER];
+	maps.BY_PIECE[KING] = 0;
+	for (Bitboard K = KINGS; K; ) {
+		const Bitboard SPAN = king_span(pop_lsb(K));
+		maps.BY_PIECE[KING] |= SPAN;
+		mobility += popcount(SPAN & SAFE);
+	}
+	
+	maps.BY_PIECE[EMPTY] = 0;
+	maps.ALL = maps.BY_PIECE[PAWN] | maps.BY_PIECE[KNIGHT] | maps.BY_PIECE[BISHOP] | maps.BY_PIECE[ROOK] | maps.BY_PIECE[QUEEN] | maps.BY_PIECE[KING];
+	maps.mobility = mobility;
+	maps.KING_ATTACKERS = (PIECES[KING] & PLAYERS[OPPONENT] & maps.ALL) ? king_attackers<PLAYER>() : 0;
+}
+
+template<Variant V>
+inline void Game<V>::invalidate_attack_maps()
+{
+	attack_maps_are_valid[WHITE] = false;
+	attack_maps_are_valid[BLACK] = false;
+}
 
 // MARK: - Check
 
@@ -361,7 +500,7 @@ inline bool Game<V>::is_check(Color player) const
 {
 	if constexpr (Variants::has_check_disabled(V))
 		return false;
-	return PIECES[KING] & PLAYERS[player] & (player == WHITE ? attacked_squares<BLACK>() : attacked_squares<WHITE>());
+	return player == WHITE ? king_attackers<BLACK>() : king_attackers<WHITE>();
 }
 
 template<Variant V>
@@ -463,7 +602,19 @@ inline void Game<V>::apply(Move move)
 	EN_PASSANT_HISTORY.push_back(EN_PASSANT);
 	castling_rights_history.push_back(castling_rights);
 	hash_history.push_back(hash);
+	pawn_hash_history.push_back(pawn_hash);
 	reversible_move_clock_history.push_back(reversible_move_clock);
+	piece_scores_history.push_back(piece_scores);
+	if (const NNUE::Network *network = NNUE::networks[V].get()) {
+		// Start from the previous accumulator, which the piece score updates below bring up to date
+		const size_t ply = move_history.size();
+		if (accumulators.size() <= ply)
+			accumulators.resize(ply + 1);
+		if (accumulators[ply - 1].belongs_to(network))
+			accumulators[ply] = accumulators[ply - 1];
+		else
+			accumulators[ply].network = nullptr;
+	}
 	
 	const int from = move_from(move);
 	const int to = move_to(move);
@@ -504,14 +655,25 @@ inline void Game<V>::apply(Move move)
 	PIECES[piece] &= ~FROM;
 	PLAYERS[active_player] &= ~FROM;
 	hash ^= Zobrist::keys[from][active_player][piece];
+	remove_piece_scores(from, piece, active_player);
 	// Captured piece
 	PIECES[captured_piece] &= ~TO;
 	PLAYERS[captured_piece_color] &= ~TO;
 	hash ^= Zobrist::keys[to][captured_piece_color][captured_piece];
+	if (captured_piece)
+		remove_piece_scores(to, captured_piece, captured_piece_color);
 	// To
 	PIECES[promotion] |= TO;
 	PLAYERS[active_player] |= TO;
 	hash ^= Zobrist::keys[to][active_player][promotion];
+	add_piece_scores(to, promotion, active_player);
+	// Pawn structure
+	if (piece == PAWN)
+		pawn_hash ^= Zobrist::keys[from][active_player][PAWN];
+	if (captured_piece == PAWN)
+		pawn_hash ^= Zobrist::keys[to][captured_piece_color][PAWN];
+	if (promotion == PAWN)
+		pawn_hash ^= Zobrist::keys[to][active_player][PAWN];
 	
 	// Piece list
 	list[from] = EMPTY;
@@ -529,6 +691,9 @@ inline void Game<V>::apply(Move move)
 				PIECES[exploded_piece] &= ~SQUARE;
 				PLAYERS[exploded_piece_color] &= ~SQUARE;
 				hash ^= Zobrist::keys[square][exploded_piece_color][exploded_piece];
+				remove_piece_scores(square, exploded_piece, exploded_piece_color);
+				if (exploded_piece == PAWN)
+					pawn_hash ^= Zobrist::keys[square][exploded_piece_color][PAWN];
 				list[square] = EMPTY;
 			}
 		}
@@ -551,6 +716,8 @@ inline void Game<V>::apply(Move move)
 		PLAYERS[captured_piece_color] &= ~CAPTURED_PAWN;
 		list[captured_pawn] = EMPTY;
 		hash ^= Zobrist::keys[captured_pawn][captured_piece_color][PAWN];
+		remove_piece_scores(captured_pawn, PAWN, captured_piece_color);
+		pawn_hash ^= Zobrist::keys[captured_pawn][captured_piece_color][PAWN];
 	}
 	
 	// En passant
@@ -575,6 +742,8 @@ inline void Game<V>::apply(Move move)
 			list[from + 1] = ROOK;
 			hash ^= Zobrist::keys[from + 3][active_player][ROOK];
 			hash ^= Zobrist::keys[from + 1][active_player][ROOK];
+			remove_piece_scores(from + 3, ROOK, active_player);
+			add_piece_scores(from + 1, ROOK, active_player);
 		}
 		else if (from - to == 2) {
 			// Queenside castling
@@ -586,6 +755,8 @@ inline void Game<V>::apply(Move move)
 			list[from - 1] = ROOK;
 			hash ^= Zobrist::keys[from - 4][active_player][ROOK];
 			hash ^= Zobrist::keys[from - 1][active_player][ROOK];
+			remove_piece_scores(from - 4, ROOK, active_player);
+			add_piece_scores(from - 1, ROOK, active_player);
 		}
 		if (can_castle_kingside(active_player))
 			remove_kingside_castling_right(active_player);
@@ -649,7 +820,9 @@ inline void Game<V>::undo()
 	EN_PASSANT = EN_PASSANT_HISTORY.back(); EN_PASSANT_HISTORY.pop_back();
 	castling_rights = castling_rights_history.back(); castling_rights_history.pop_back();
 	hash = hash_history.back(); hash_history.pop_back();
+	pawn_hash = pawn_hash_history.back(); pawn_hash_history.pop_back();
 	reversible_move_clock = reversible_move_clock_history.back(); reversible_move_clock_history.pop_back();
+	piece_scores = piece_scores_history.back(); piece_scores_history.pop_back();
 	
 	active_player = !active_player;
 	
@@ -799,6 +972,51 @@ inline void Game<V>::remove_queenside_castling_right(Color player)
 }
 
 
+// MARK: - Piece Scores
+
+template<Variant V>
+inline void Game<V>::add_piece_scores(int square, Piece piece, Color player)
+{
+	piece_scores.material[player] += Magic::PIECE_SCORES[player][piece][square];
+	piece_scores.endgame_progress[player] += Magic::ENDGAME_PROGRESS[piece];
+	if (const NNUE::Network *network = NNUE::networks[V].get()) {
+		NNUE::Accumulator &accumulator = accumulators[move_history.size()];
+		if (accumulator.belongs_to(network))
+			accumulator.add_piece(square, piece, player);
+	}
+}
+
+template<Variant V>
+inline void Game<V>::remove_piece_scores(int square, Piece piece, Color player)
+{
+	piece_scores.material[player] -= Magic::PIECE_SCORES[player][piece][square];
+	piece_scores.endgame_progress[player] -= Magic::ENDGAME_PROGRESS[piece];
+	if (const NNUE::Network *network = NNUE::networks[V].get()) {
+		NNUE::Accumulator &accumulator = accumulators[move_history.size()];
+		if (accumulator.belongs_to(network))
+			accumulator.remove_piece(square, piece, player);
+	}
+}
+
+template<Variant V>
+inline const NNUE::Accumulator &Game<V>::accumulator(const NNUE::Network &network) const
+{
+	const size_t ply = move_history.size();
+	if (accumulators.size() <= ply)
+		accumulators.resize(ply + 1);
+	NNUE::Accumulator &accumulator = accumulators[ply];
+	if (!accumulator.belongs_to(&network)) {
+		accumulator.reset(network);
+		Bitboard B = OCCUPIED;
+		while (B) {
+			const int square = pop_lsb(B);
+			accumulator.add_piece(square, list[square], color_at_square(square_to_bitboard(square)));
+		}
+	}
+	return accumulator;
+}
+
+
 // MARK: - SPAN
 
 template<Variant V>
@@ -13,8 +13,18 @@
 #include "definitions.h"
 #include "variants.h"
 #include "table.h"
+#include "nnue.h"
 #include <memory>
 
+/// Totals that the evaluation needs for every position, kept up to date by `apply` and `undo` so that they never have to be recomputed from the board.
+struct PieceScores
+{
+	/// Usage: `material[player]`. The sum of `Magic::PIECE_SCORES[player][piece][square]` over all of `player`'s pieces.
+	Score material[2];
+	/// Usage: `endgame_progress[player]`. The sum of `Magic::ENDGAME_PROGRESS[piece]` over all of `player`'s pieces.
+	int endgame_progress[2];
+};
+
 class AbstractGame
 {
 public:
@@ -33,7 +43,9 @@ public:
 	std::vector<CastlingRights> castling_rights_history;
 	std::vector<Bitboard> EN_PASSANT_HISTORY;
 	std::vector<HashKey> hash_history;
+	std::vector<HashKey> pawn_hash_history;
 	std::vector<int> reversible_move_clock_history;
+	std::vector<PieceScores> piece_scores_history;
 	
 	// These vectors will only be used for variants that have destructive moves
 	std::vector<std::array<Bitboard, PIECE_COUNT>> PIECES_HISTORY;
@@ -46,6 +58,9 @@ public:
 	bool fifty_move_rule_enabled = true;
 	
 	HashKey hash;
+	/// Hash of the pawns alone, built from the same `Zobrist::keys` as `hash`. Positions with the same pawn structure share it.
+	HashKey pawn_hash;
+	PieceScores piece_scores;
 	
 	/// Returns a pointer to a new instance of `Game<variant>`.
 	static std::unique_ptr<AbstractGame> instantiate(Variant variant);
@@ -95,6 +110,19 @@ public:
 };
 
 
+/// Everything one player attacks in a position. Computed at most once per position by `Game::attack_maps()`.
+struct AttackMaps
+{
+	/// All squares that the player attacks.
+	Bitboard ALL;
+	/// Usage: `BY_PIECE[piece]`. The squares that the player's pieces of type `piece` attack.
+	Bitboard BY_PIECE[PIECE_COUNT];
+	/// The player's pieces that attack an enemy king.
+	Bitboard KING_ATTACKERS;
+	/// The number of safe squares that the player's pieces can move to. A square is safe if it is not attacked by an enemy pawn and the player would be allowed to capture whatever stands on it.
+	int mobility;
+};
+
 template<Variant V>
 class Game: public AbstractGame
 {
@@ -103,6 +131,14 @@ public:
 	/// All quasi-legal moves. Generated by `generate_quasilegal_moves()`.
 	mutable std::vector<Move> quasilegal_moves;
 	
+	/// Usage: `attack_maps_cache[player]`. Only meaningful while `attack_maps_are_valid[player]` is set and `attack_maps_hash[player]` is the current hash. Keying the maps to the hash means that `apply` and `undo` don't have to discard them, so they survive trying a move and taking it back. The setup methods clear the flags, since they change the board without updating the hash.
+	mutable AttackMaps attack_maps_cache[2];
+	mutable uint64_t attack_maps_hash[2] = {0, 0};
+	mutable bool attack_maps_are_valid[2] = {false, false};
+	
+	/// Usage: `accumulators[move_history.size()]`. The first layer of `NNUE::networks[V]` for the current position and the positions before it. Only kept up to date while a network is loaded.
+	mutable std::vector<NNUE::Accumulator> accumulators = std::vector<NNUE::Accumulator>(1);
+	
 	Game();
 	
 	std::unique_ptr<AbstractGame> clone() const;
@@ -136,9 +172,22 @@ public:
 	void generate_quasilegal_moves() const;
 	
 	std::vector<Move> legal_moves();
+	/// Like `legal_moves()`, but fills `moves` instead of allocating a new vector, so that its capacity can be reused.
+	void legal_moves(std::vector<Move> &moves);
 	
+	/// Returns the squares that `PLAYER` attacks. Uses the cached attack maps if they are up to date, but doesn't compute them, since that also counts mobility.
 	template<Color PLAYER>
 	Bitboard attacked_squares() const;
+	/// Returns `PLAYER`'s pieces that attack an enemy king, found by looking outwards from each enemy king. Check detection uses this, so that testing a move for legality never computes the full attack maps.
+	template<Color PLAYER>
+	Bitboard king_attackers() const;
+	/// Returns the attack maps of `PLAYER`, computing them only if the position has changed since they were last computed. Meant for the evaluation; move generation and check detection use the cheaper functions above.
+	template<Color PLAYER>
+	const AttackMaps &attack_maps() const;
+	template<Color PLAYER>
+	void compute_attack_maps(AttackMaps &maps) const;
+	/// Discards the cached attack maps. Must be called whenever the board changes without the hash being updated.
+	void invalidate_attack_maps();
 	
 	void apply(Move move);
 	void undo();
@@ -153,6 +202,13 @@ public:
 	void remove_kingside_castling_right(Color player);
 	void remove_queenside_castling_right(Color player);
 	
+	/// Adds the scores of `player`'s `piece` on `square` to `piece_scores`.
+	void add_piece_scores(int square, Piece piece, Color player);
+	/// Removes the scores of `player`'s `piece` on `square` from `piece_scores`.
+	void remove_piece_scores(int square, Piece piece, Color player);
+	/// Returns the accumulator of the current position for `network`, computing it from scratch if it is out of date.
+	const NNUE::Accumulator &accumulator(const NNUE::Network &network) const;
+	
 	Bitboard adjacent_squares(int square) const;
 	Bitboard horizontal_vertical_span(int square) const;
 	Bitboard diagonal_span(int square) const;
@@ -27,7 +27,7 @@ Bitboard DIAGONAL_SPAN[64][256];
 Bitboard ANTI_DIAGONAL_MULTIPLICAND[64];
 Bitboard ANTI_DIAGONAL_SPAN[64][256];
 
-int PIECE_SCORES[2][2][PIECE_COUNT][64];
+Score PIECE_SCORES[2][PIECE_COUNT][64];
 
 
 void init()
@@ -223,45 +223,45 @@ void init()
 	}
 	
 	// Initialize `PIECE_SCORES`
-	for (int endgame = false; endgame <= true; endgame++) {
-		for (int player = WHITE; player <= BLACK; player++) {
-			for (Piece piece = EMPTY; piece <= KING; piece++) {
-				for (int square = 0; square < 64; square++) {
-					
-					int score = 0;
-					switch (piece) {
-						case EMPTY:
-							score = EMPTY_SCORES[square];
-							break;
-						case PAWN:
-							score = PAWN_SCORES[square];
-							break;
-						case KNIGHT:
-							score = KNIGHT_SCORES[square];
-							break;
-						case BISHOP:
-							score = BISHOP_SCORES[square];
-							break;
-						case ROOK:
-							score = ROOK_SCORES[square];
-							break;
-						case QUEEN:
-							score = QUEEN_SCORES[square];
-							break;
-						case KING:
-							score = endgame ? KING_SCORES_ENDGAME[square] : KING_SCORES_MIDDLEGAME[square];
-							break;
-					}
-					
-					score += endgame ? MATERIAL_SCORES_ENDGAME[piece] : MATERIAL_SCORES_MIDDLEGAME[piece];
-					
-					int y = square / 8, x = square % 8;
-					// Flip this square vertically if the player is white
-					if (player == WHITE)
-						y = 7 - y;
-					int new_square = 8 * y + x;
-					PIECE_SCORES[endgame][player][piece][new_square] = score;
+	for (int player = WHITE; player <= BLACK; player++) {
+		for (Piece piece = EMPTY; piece <= KING; piece++) {
+			for (int square = 0; square < 64; square++) {
+				
+				int score[2] = {0, 0};
+				switch (piece) {
+					case EMPTY:
+						score[false] = score[true] = EMPTY_SCORES[square];
+						break;
+					case PAWN:
+						score[false] = score[true] = PAWN_SCORES[square];
+						break;
+					case KNIGHT:
+						score[false] = score[true] = KNIGHT_SCORES[square];
+						break;
+					case BISHOP:
+						score[false] = score[true] = BISHOP_SCORES[square];
+						break;
+					case ROOK:
+						score[false] = score[true] = ROOK_SCORES[square];
+						break;
+					case QUEEN:
+						score[false] = score[true] = QUEEN_SCORES[square];
+						break;
+					case KING:
+						score[false] = KING_SCORES_MIDDLEGAME[square];
+						score[true] = KING_SCORES_ENDGAME[square];
+						break;
 				}
+				
+				score[false] += MATERIAL_SCORES_MIDDLEGAME[piece];
+				score[true] += MATERIAL_SCORES_ENDGAME[piece];
+				
+				int y = square / 8, x = square % 8;
+				// Flip this square vertically if the player is white
+				if (player == WHITE)
+					y = 7 - y;
+				int new_square = 8 * y + x;
+				PIECE_SCORES[player][piece][new_square] = make_score(score[false], score[true]);
 			}
 		}
 	}
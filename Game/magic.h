@@ -11,6 +11,7 @@
 
 #include "fruit.h"
 #include "bitboard.h"
+#include "evaluation_parameters.h"
 
 namespace Magic
 {
@@ -62,14 +63,7 @@ constexpr int ENDGAME_PROGRESS[PIECE_COUNT] =
 	0, 0, 1, 1, 2, 4, 0
 };
 
-constexpr int MATERIAL_SCORES_MIDDLEGAME[PIECE_COUNT] =
-{
-	0, 90, 290, 300, 500, 900, 0
-};
-constexpr int MATERIAL_SCORES_ENDGAME[PIECE_COUNT] =
-{
-	0, 120, 250, 310, 540, 940, 0
-};
+// The material and piece-square scores themselves are in `evaluation_parameters.h`, where the tuner can rewrite them
 
 constexpr int EMPTY_SCORES[64] =
 {
@@ -82,86 +76,23 @@ constexpr int EMPTY_SCORES[64] =
 	  0,   0,   0,   0,   0,   0,   0,   0,
 	  0,   0,   0,   0,   0,   0,   0,   0,
 };
-constexpr int PAWN_SCORES[64] =
-{
-	  0,   0,   0,   0,   0,   0,   0,   0,
-	 40,  40,  40,  40,  40,  40,  40,  40,
-	 30,  30,  30,  35,  35,  30,  30,  30,
-	 15,  20,  20,  30,  30,  20,  20,  15,
-	  5,   5,  10,  30,  30,  10,   5,   5,
-	  0,   5,  -5, -10, -10,  -5,   5,   0,
-	  0,   0,   0, -10, -10,   0,   0,   0,
-	  0,   0,   0,   0,   0,   0,   0,   0,
-};
-constexpr int KNIGHT_SCORES[64] =
-{
-	-30, -25, -20, -20, -20, -20, -25, -30,
-	-25,   0,   0,   0,   0,   0,   0, -25,
-	-20,   0,   0,   5,   5,   0,   0, -20,
-	-20,   0,   5,  15,  15,   5,   0, -20,
-	-20,   5,   5,  15,  15,   5,   5, -20,
-	-20,   0,   5,   0,   0,   5,   0, -20,
-	-25,   0,   0,   0,   0,   0,   0, -25,
-	-30, -10, -20, -20, -20, -20, -10, -30,
-};
-constexpr int BISHOP_SCORES[64] =
-{
-	 -5,  -5,  -5,  -5,  -5,  -5,  -5,  -5,
-	 -5,   0,   0,   0,   0,   0,   0,  -5,
-	 -5,   0,   0,   0,   0,   0,   0,  -5,
-	 -5,   5,   0,   5,   5,   0,   5,  -5,
-	 -5,   0,  10,   5,   5,  10,   0,  -5,
-	 -5,   0,   0,   0,   0,   0,   0,  -5,
-	 -5,  20,   0,   0,   0,   0,  20,  -5,
-	 -5,  -5,  -5,  -5,  -5,  -5,  -5,  -5,
-};
-constexpr int ROOK_SCORES[64] =
-{
-	  0,   0,   0,   0,   0,   0,   0,   0,
-	 10,  10,  10,  15,  15,  10,  10,  10,
-	-10,   0,   0,   0,   0,   0,   0, -10,
-	-10,   0,   0,   0,   0,   0,   0, -10,
-	-10,   0,   0,   0,   0,   0,   0, -10,
-	-10,   0,   0,   0,   0,   0,   0, -10,
-	-10,   0,   0,   0,   0,   0,   0, -10,
-	  0,   0,   0,  15,  15,   0,   0,   0,
-};
-constexpr int QUEEN_SCORES[64] =
-{
-	-10,  -5,  -5,  -5,  -5,  -5,  -5, -10,
-	 -5,   0,   0,   0,   0,   0,   0,  -5,
-	 -5,   0,   0,   5,   5,   0,   0,  -5,
-	 -5,   0,   5,   5,   5,   5,   0,  -5,
-	 -5,   0,   5,   5,   5,   5,   0,  -5,
-	 -5,   0,   0,   5,   5,   0,   0,  -5,
-	 -5,   0,   0,  10,  10,   0,   0,  -5,
-	-10,  -5,  -5,  -5,  -5,  -5,  -5, -10,
-};
-constexpr int KING_SCORES_MIDDLEGAME[64] =
-{
-	-30, -30, -35, -35, -35, -35, -30, -30,
-	-25, -25, -30, -30, -30, -30, -25, -25,
-	-20, -20, -25, -25, -25, -25, -20, -20,
-	-15, -15, -20, -20, -20, -20, -15, -15,
-	-10, -10, -15, -15, -15, -15, -10, -10,
-	 -5,  -5, -10, -10, -10, -10,  -5,  -5,
-	  0,   0,   0,   0,   0,   0,   0,   0,
-	 10,  50,  70,   0,   0,   5,  70,  40,
-};
-constexpr int KING_SCORES_ENDGAME[64] =
-{
-	-20, -10,  -5,  -5,  -5,  -5, -10, -20,
-	-10,   0,   0,   0,   0,   0,   0, -10,
-	  0,  25,  30,  30,  30,  30,  25,   0,
-	  0,  20,  30,  40,  40,  30,  20,   0,
-	  5,   5,  30,  40,  40,  30,   5,   5,
-	-10,   5,  20,  30,  30,  20,   5, -10,
-	-30, -15,   0,   0,  0,   0, -15, -30,
-	-40, -30, -15,  -5,  -5, -15, -30, -40,
-};
 
-/// Usage: `PIECE_SCORES[endgame][player][piece][square]`.
-extern int PIECE_SCORES[2][2][PIECE_COUNT][64];
+/// Usage: `PIECE_SCORES[player][piece][square]`. The material and piece-square score in both phases.
+extern Score PIECE_SCORES[2][PIECE_COUNT][64];
+
+
+// MARK: - Pawn Structure
+
+/// The ranks in the enemy half of the board where a knight makes a good outpost. Usage: `OUTPOST_RANKS[player]`.
+constexpr Bitboard OUTPOST_RANKS[2] = {0xffffffULL << A4, 0xffffffULL << A3};
+
+
+// MARK: - King of the Hill
+
+/// Applies to a king inside `RING_OF_RADIUS_2`.
+constexpr int KING_NEAR_HILL_SCORE = 400;
+/// Applies to a king inside `RING_OF_RADIUS_3`, but not `RING_OF_RADIUS_2`.
+constexpr int KING_APPROACHING_HILL_SCORE = 200;
 
 } // namespace Magic
 
@@ -0,0 +1,131 @@
+//
+//  nnue.cpp
+//  Chaos Chess (Hummingbird)
+//
+//  Created by McKinley Keys on 10/19/26.
+//
+
+#include "nnue.h"
+#include <cstring>
+
+namespace NNUE
+{
+
+std::unique_ptr<Network> networks[VARIANT_COUNT];
+
+constexpr uint32_t VERSION = 1;
+/// The generation of the most recently loaded network.
+static uint32_t last_generation = 0;
+
+
+// MARK: - Inference
+
+int Network::evaluate(const Accumulator &accumulator, Color player) const
+{
+	// Clip the accumulator into the activation range, active player first
+	alignas(32) int8_t inputs[2 * ACCUMULATOR_SIZE];
+	const int16_t *halves[] = {accumulator.values[player], accumulator.values[!player]};
+	for (int half = 0; half < 2; half++) {
+#ifdef __AVX2__
+		for (int index = 0; index < ACCUMULATOR_SIZE; index += 32) {
+			const __m256i low = _mm256_load_si256((const __m256i *)(halves[half] + index));
+			const __m256i high = _mm256_load_si256((const __m256i *)(halves[half] + index + 16));
+			// `packs` saturates at `ACTIVATION_LIMIT` and interleaves the 128-bit lanes, which the permutation undoes
+			const __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi16(low, high), 0b11011000);
+			_mm256_store_si256((__m256i *)(inputs + half * ACCUMULATOR_SIZE + index), _mm256_max_epi8(packed, _mm256_setzero_si256()));
+		}
+#else
+		for (int index = 0; index < ACCUMULATOR_SIZE; index++)
+			inputs[half * ACCUMULATOR_SIZE + index] = (int8_t)std::clamp((int)halves[half][index], 0, ACTIVATION_LIMIT);
+#endif
+	}
+	
+	// Hidden layer
+	int32_t output = output_bias;
+	for (int neuron = 0; neuron < HIDDEN_SIZE; neuron++) {
+		int32_t sum = hidden_biases[neuron];
+#ifdef __AVX2__
+		// The inputs are never negative, so they can be treated as unsigned. Each 16-bit pair sum is at most 2 * 127 * 128, so `maddubs` can't saturate.
+		const __m256i ones = _mm256_set1_epi16(1);
+		__m256i sums = _mm256_setzero_si256();
+		for (int index = 0; index < 2 * ACCUMULATOR_SIZE; index += 32) {
+			const __m256i products = _mm256_maddubs_epi16(_mm256_load_si256((const __m256i *)(inputs + index)), _mm256_load_si256((const __m256i *)(hidden_weights[neuron] + index)));
+			sums = _mm256_add_epi32(sums, _mm256_madd_epi16(products, ones));
+		}
+		const __m128i half_sums = _mm_add_epi32(_mm256_castsi256_si128(sums), _mm256_extracti128_si256(sums, 1));
+		const __m128i quarter_sums = _mm_add_epi32(half_sums, _mm_shuffle_epi32(half_sums, 0b01001110));
+		sum += _mm_cvtsi128_si32(_mm_add_epi32(quarter_sums, _mm_shuffle_epi32(quarter_sums, 0b10110001)));
+#else
+		for (int index = 0; index < 2 * ACCUMULATOR_SIZE; index++)
+			sum += inputs[index] * hidden_weights[neuron][index];
+#endif
+		const int32_t activation = std::clamp(sum >> HIDDEN_SHIFT, 0, ACTIVATION_LIMIT);
+		output += activation * output_weights[neuron];
+	}
+	
+	return output / OUTPUT_SCALE;
+}
+
+
+// MARK: - Loading
+
+template<typename T>
+static bool read(const std::string &contents, size_t &offset, T *destination, size_t count)
+{
+	const size_t size = sizeof(T) * count;
+	if (offset + size > contents.size())
+		return false;
+	std::memcpy(destination, contents.data() + offset, size);
+	offset += size;
+	return true;
+}
+
+bool load(Variant variant, const std::string &file_url)
+{
+	if (!fruit::file_exists(file_url)) {
+		cout << fruit::debug_description(file_url) << " does not exist" << endl;
+		return false;
+	}
+	const std::optional<std::string> optional_contents = fruit::slurp(file_url);
+	if (!optional_contents.has_value()) {
+		cout << "Failed to load network " << fruit::debug_description(file_url) << endl;
+		return false;
+	}
+	const std::string &contents = optional_contents.value();
+	
+	size_t offset = 0;
+	char signature[4];
+	uint32_t header[4];
+	if (!read(contents, offset, signature, 4) || std::memcmp(signature, "HBNN", 4) != 0 || !read(contents, offset, header, 4)) {
+		cout << fruit::debug_description(file_url) << " is not a Hummingbird network" << endl;
+		return false;
+	}
+	if (header[0] != VERSION || header[1] != FEATURE_COUNT || header[2] != ACCUMULATOR_SIZE || header[3] != HIDDEN_SIZE) {
+		cout << fruit::debug_description(file_url) << " has an unsupported version or shape" << endl;
+		return false;
+	}
+	
+	auto network = std::make_unique<Network>();
+	const bool is_complete =
+		read(contents, offset, &network->feature_weights[0][0], FEATURE_COUNT * ACCUMULATOR_SIZE) &&
+		read(contents, offset, network->feature_biases, ACCUMULATOR_SIZE) &&
+		read(contents, offset, &network->hidden_weights[0][0], HIDDEN_SIZE * 2 * ACCUMULATOR_SIZE) &&
+		read(contents, offset, network->hidden_biases, HIDDEN_SIZE) &&
+		read(contents, offset, network->output_weights, HIDDEN_SIZE) &&
+		read(contents, offset, &network->output_bias, 1);
+	if (!is_complete || offset != contents.size()) {
+		cout << fruit::debug_description(file_url) << " has the wrong size" << endl;
+		return false;
+	}
+	
+	network->generation = ++last_generation;
+	networks[variant] = std::move(network);
+	return true;
+}
+
+void unload(Variant variant)
+{
+	networks[variant].reset();
+}
+
+} // namespace NNUE
@@ -0,0 +1,137 @@
+//
+//  nnue.h
+//  Chaos Chess (Hummingbird)
+//
+//  Created by McKinley Keys on 10/19/26.
+//
+
+#pragma once
+#ifndef nnue_h
+#define nnue_h
+
+#include "fruit.h"
+#include "definitions.h"
+#include "variants.h"
+#include <memory>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+/// An efficiently updatable neural network that can stand in for the hand-written evaluation. Each variant has its own network, so that it can learn that variant's objective.
+///
+/// There is one input feature for each piece on each square, seen from each player's perspective. For black the board is flipped vertically, and in both perspectives "friendly" and "enemy" take the place of white and black, so that both perspectives share the same weights. The first layer is kept in an `Accumulator` that `Game` updates as pieces move, so an evaluation only has to compute the small layers after it.
+namespace NNUE
+{
+
+constexpr int FEATURE_COUNT = 2 * 6 * 64;
+/// The number of neurons in the first layer, for each perspective.
+constexpr int ACCUMULATOR_SIZE = 128;
+constexpr int HIDDEN_SIZE = 32;
+/// Activations are quantized to `0 ... ACTIVATION_LIMIT`.
+constexpr int ACTIVATION_LIMIT = 127;
+/// Brings the sums of the hidden layer back into the activation range.
+constexpr int HIDDEN_SHIFT = 6;
+/// The output of the network is divided by this to get centipawns.
+constexpr int OUTPUT_SCALE = 16;
+
+/// Returns the feature of `player`'s `piece` on `square`, as seen by `perspective`.
+inline int feature(Color perspective, Color player, Piece piece, int square)
+{
+	if (perspective == BLACK)
+		square ^= 56;
+	return ((player != perspective) * 6 + (piece - PAWN)) * 64 + square;
+}
+
+struct Accumulator;
+
+struct Network
+{
+	/// Usage: `feature_weights[feature][neuron]`.
+	alignas(32) int16_t feature_weights[FEATURE_COUNT][ACCUMULATOR_SIZE];
+	alignas(32) int16_t feature_biases[ACCUMULATOR_SIZE];
+	/// Usage: `hidden_weights[neuron][input]`. The inputs are the active player's half of the accumulator followed by the other player's.
+	alignas(32) int8_t hidden_weights[HIDDEN_SIZE][2 * ACCUMULATOR_SIZE];
+	alignas(32) int32_t hidden_biases[HIDDEN_SIZE];
+	alignas(32) int8_t output_weights[HIDDEN_SIZE];
+	int32_t output_bias;
+	/// Distinguishes this network from earlier ones that were loaded at the same address.
+	uint32_t generation;
+	
+	/// Returns the evaluation of the position that `accumulator` describes, in centipawns, from the point of view of `player`.
+	int evaluate(const Accumulator &accumulator, Color player) const;
+};
+
+/// The first layer of a network for one position.
+struct Accumulator
+{
+	/// Usage: `values[perspective][neuron]`.
+	alignas(32) int16_t values[2][ACCUMULATOR_SIZE];
+	/// The network that `values` belong to, or `nullptr` if they are out of date.
+	const Network *network = nullptr;
+	uint32_t network_generation = 0;
+	
+	/// Returns whether `values` are up to date for `other_network`.
+	inline bool belongs_to(const Network *other_network) const
+	{
+		return network == other_network && network_generation == other_network->generation;
+	}
+	
+	/// Sets the accumulator up for an empty board.
+	inline void reset(const Network &new_network)
+	{
+		network = &new_network;
+		network_generation = new_network.generation;
+		std::copy(network->feature_biases, network->feature_biases + ACCUMULATOR_SIZE, values[WHITE]);
+		std::copy(network->feature_biases, network->feature_biases + ACCUMULATOR_SIZE, values[BLACK]);
+	}
+	inline void add_piece(int square, Piece piece, Color player)
+	{
+		add(values[WHITE], network->feature_weights[feature(WHITE, player, piece, square)]);
+		add(values[BLACK], network->feature_weights[feature(BLACK, player, piece, square)]);
+	}
+	inline void remove_piece(int square, Piece piece, Color player)
+	{
+		subtract(values[WHITE], network->feature_weights[feature(WHITE, player, piece, square)]);
+		subtract(values[BLACK], network->feature_weights[feature(BLACK, player, piece, square)]);
+	}
+	
+private:
+	static inline void add(int16_t *neurons, const int16_t *weights)
+	{
+#ifdef __AVX2__
+		for (int index = 0; index < ACCUMULATOR_SIZE; index += 16) {
+			__m256i *target = (__m256i *)(neurons + index);
+			*target = _mm256_add_epi16(*target, _mm256_load_si256((const __m256i *)(weights + index)));
+		}
+#else
+		for (int index = 0; index < ACCUMULATOR_SIZE; index++)
+			neurons[index] += weights[index];
+#endif
+	}
+	static inline void subtract(int16_t *neurons, const int16_t *weights)
+	{
+#ifdef __AVX2__
+		for (int index = 0; index < ACCUMULATOR_SIZE; index += 16) {
+			__m256i *target = (__m256i *)(neurons + index);
+			*target = _mm256_sub_epi16(*target, _mm256_load_si256((const __m256i *)(weights + index)));
+		}
+#else
+		for (int index = 0; index < ACCUMULATOR_SIZE; index++)
+			neurons[index] -= weights[index];
+#endif
+	}
+};
+
+/// Usage: `networks[variant]`. Empty for variants without a network, which use the hand-written evaluation.
+extern std::unique_ptr<Network> networks[VARIANT_COUNT];
+
+/// Loads the network for `variant` from `file_url`, replacing the one that is loaded. Returns whether the file could be loaded.
+///
+/// The file starts with the characters `HBNN`, followed by the version and the sizes `FEATURE_COUNT`, `ACCUMULATOR_SIZE` and `HIDDEN_SIZE` as little-endian 32-bit integers. After that come the members of `Network` in order, as little-endian integers of their own types.
+bool load(Variant variant, const std::string &file_url);
+/// Goes back to the hand-written evaluation for `variant`.
+void unload(Variant variant);
+
+} // namespace NNUE
+
+#endif /* nnue_h */
@@ -0,0 +1,1021 @@
+//
+//  syzygy.cpp
+//  Chaos Chess (Hummingbird)
+//
+//  Created by McKinley Keys on 10/19/26.
+//
+
+#include "syzygy.h"
+#include "game.h"
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Syzygy
+{
+
+int largest_table_size = 0;
+
+namespace
+{
+
+constexpr int MAX_PIECES = 7;
+
+enum TableType
+{
+	WDL_TABLE, DTZ_TABLE
+};
+
+enum ProbeResult
+{
+	/// The position needs a table that is missing or can't be read.
+	FAILED,
+	SUCCEEDED,
+	/// A DTZ table only stores one player to move, and it isn't the player to move in this position.
+	WRONG_PLAYER_TO_MOVE,
+	/// The best move is a zeroing move, so the DTZ table doesn't store a meaningful value for this position.
+	ZEROING_BEST_MOVE,
+};
+
+// Flags in `PairsData::flags`
+constexpr uint8_t STORES_BLACK_TO_MOVE = 1, HAS_DTZ_MAP = 2, WINS_IN_PLIES = 4, LOSSES_IN_PLIES = 8, HAS_WIDE_DTZ_MAP = 16, HAS_SINGLE_VALUE = 128;
+
+// MARK: - Indexing
+
+/// Usage: `BINOMIAL[k][n]`. The number of ways to choose `k` squares out of `n`.
+uint64_t BINOMIAL[6][64];
+/// Numbers the squares below the a1-h8 diagonal `0 ..< 28`.
+int BELOW_DIAGONAL_INDEX[64];
+/// Numbers the squares of the a1-d1-d4 triangle `0 ..< 10`, with the squares on the diagonal last.
+int TRIANGLE_INDEX[64];
+/// Usage: `KING_PAIR_INDEX[TRIANGLE_INDEX[first_king]][second_king]`. Numbers the 462 legal placements of two kings where the first one is in the a1-d1-d4 triangle, and the second one isn't above the diagonal if the first one is on it.
+int KING_PAIR_INDEX[10][64];
+/// Numbers the squares a2 ... h7 `0 ..< 48`, so that the leading pawn (the one that decides which table to use) is the one with the highest number: the pawn closest to the edge, and the lowest of those.
+int PAWN_INDEX[64];
+/// Usage: `LEADING_PAWN_INDEX[leading_pawn_count][square]`.
+uint64_t LEADING_PAWN_INDEX[6][64];
+/// Usage: `LEADING_PAWN_GROUP_SIZE[leading_pawn_count][file]`.
+uint64_t LEADING_PAWN_GROUP_SIZE[6][4];
+
+inline int rank_of(int square)
+{
+	return square / 8;
+}
+inline int file_of(int square)
+{
+	return square % 8;
+}
+/// Positive above the a1-h8 diagonal, negative below it.
+inline int diagonal_offset(int square)
+{
+	return rank_of(square) - file_of(square);
+}
+
+void init_indices()
+{
+	int index = 0;
+	for (int square = 0; square < 64; square++)
+		if (diagonal_offset(square) < 0)
+			BELOW_DIAGONAL_INDEX[square] = index++;
+	
+	index = 0;
+	std::vector<int> diagonal;
+	for (int square = A1; square <= D4; square++) {
+		if (diagonal_offset(square) < 0 && file_of(square) <= 3)
+			TRIANGLE_INDEX[square] = index++;
+		else if (diagonal_offset(square) == 0 && file_of(square) <= 3)
+			diagonal.push_back(square);
+	}
+	for (int square : diagonal)
+		TRIANGLE_INDEX[square] = index++;
+	
+	// Placements with both kings on the diagonal come last
+	index = 0;
+	std::vector<std::pair<int, int>> both_on_diagonal;
+	for (int triangle_index = 0; triangle_index < 10; triangle_index++) {
+		for (int first = A1; first <= D4; first++) {
+			// Squares outside of the triangle are also numbered `0`, but only b1 really is
+			if (TRIANGLE_INDEX[first] != triangle_index || (triangle_index == 0 && first != B1))
+				continue;
+			for (int second = 0; second < 64; second++) {
+				const bool are_adjacent = std::abs(rank_of(first) - rank_of(second)) <= 1 && std::abs(file_of(first) - file_of(second)) <= 1;
+				if (are_adjacent)
+					continue;
+				if (diagonal_offset(first) == 0 && diagonal_offset(second) > 0)
+					continue;
+				if (diagonal_offset(first) == 0 && diagonal_offset(second) == 0)
+					both_on_diagonal.emplace_back(triangle_index, second);
+				else
+					KING_PAIR_INDEX[triangle_index][second] = index++;
+			}
+		}
+	}
+	for (const auto &[triangle_index, second] : both_on_diagonal)
+		KING_PAIR_INDEX[triangle_index][second] = index++;
+	
+	BINOMIAL[0][0] = 1;
+	for (int n = 1; n < 64; n++)
+		for (int k = 0; k < 6 && k <= n; k++)
+			BINOMIAL[k][n] = (k > 0 ? BINOMIAL[k - 1][n - 1] : 0) + (k < n ? BINOMIAL[k][n - 1] : 0);
+	
+	// A leading pawn on a2 leaves 47 squares for the other pawns, and every rank further up takes away two more
+	int available_squares = 47;
+	for (int leading_pawn_count = 1; leading_pawn_count <= 5; leading_pawn_count++) {
+		for (int file = 0; file < 4; file++) {
+			uint64_t pawn_index = 0;
+			for (int rank = 1; rank <= 6; rank++) {
+				const int square = 8 * rank + file;
+				if (leading_pawn_count == 1) {
+					PAWN_INDEX[square] = available_squares--;
+					PAWN_INDEX[square ^ 7] = available_squares--;
+				}
+				LEADING_PAWN_INDEX[leading_pawn_count][square] = pawn_index;
+				pawn_index += BINOMIAL[leading_pawn_count - 1][PAWN_INDEX[square]];
+			}
+			LEADING_PAWN_GROUP_SIZE[leading_pawn_count][file] = pawn_index;
+		}
+	}
+}
+
+
+// MARK: - Reading
+
+/// Tables store their headers in little-endian byte order and their compressed data in big-endian byte order.
+template<typename T>
+inline T read_little_endian(const uint8_t *bytes)
+{
+	T value = 0;
+	for (int index = sizeof(T); index --> 0;)
+		value = (value << 8) | bytes[index];
+	return value;
+}
+template<typename T>
+inline T read_big_endian(const uint8_t *bytes)
+{
+	T value = 0;
+	for (size_t index = 0; index < sizeof(T); index++)
+		value = (value << 8) | bytes[index];
+	return value;
+}
+
+/// Identifies a material balance by the number of each kind of piece that each player has, four bits per count.
+typedef uint64_t MaterialKey;
+
+inline MaterialKey material_key(const int counts[2][PIECE_COUNT])
+{
+	MaterialKey key = 0;
+	for (int player = WHITE; player <= BLACK; player++)
+		for (Piece piece = PAWN; piece <= QUEEN; piece++)
+			key |= (MaterialKey)counts[player][piece] << (4 * (5 * player + piece - PAWN));
+	return key;
+}
+inline MaterialKey material_key(const Game<CLASSIC> &game)
+{
+	int counts[2][PIECE_COUNT];
+	for (int player = WHITE; player <= BLACK; player++)
+		for (Piece piece = PAWN; piece <= QUEEN; piece++)
+			counts[player][piece] = popcount(game.PIECES[piece] & game.PLAYERS[player]);
+	return material_key(counts);
+}
+
+/// Pieces as the tables encode them: the piece type, plus `8` for black.
+inline uint8_t table_piece(Piece piece, Color player)
+{
+	return piece | (player == BLACK ? 8 : 0);
+}
+
+/// How a table is compressed for one player to move and, in tables with pawns, one file of the leading pawn.
+///
+/// The values are stored in the order of their indices, in blocks of `block_size` bytes. Each block is a sequence of canonical Huffman codes, and each code stands for a symbol. A symbol is either a single value or a pair of other symbols ("recursive pairing"), so that runs of values compress into one code.
+struct PairsData
+{
+	uint8_t flags = 0;
+	uint8_t max_code_length = 0;
+	/// For tables with `HAS_SINGLE_VALUE`, the value.
+	uint8_t min_code_length = 0;
+	uint32_t block_count = 0;
+	size_t block_size = 0;
+	/// Every `span` indices, `sparse_index` says where to start looking.
+	size_t span = 0;
+	/// Usage: `first_symbols[length - min_code_length]`, as little-endian 16-bit integers. The first symbol whose code has `length` bits. Longer codes belong to lower symbols.
+	const uint8_t *first_symbols = nullptr;
+	/// Usage: `symbol_pairs + 3 * symbol`. The two 12-bit symbols that a symbol stands for, or its value and `0xFFF` if it stands for a single value.
+	const uint8_t *symbol_pairs = nullptr;
+	/// Usage: `block_value_counts + 2 * block`, as little-endian 16-bit integers. The number of values in each block, minus one.
+	const uint8_t *block_value_counts = nullptr;
+	uint32_t block_value_counts_size = 0;
+	/// Usage: `sparse_index + 6 * k`. The block, as a little-endian 32-bit integer, and the offset within the block, as a little-endian 16-bit integer, of the value at index `k * span + span / 2`.
+	const uint8_t *sparse_index = nullptr;
+	size_t sparse_index_size = 0;
+	const uint8_t *blocks = nullptr;
+	/// Usage: `first_codes[length - min_code_length]`. The lowest code with `length` bits, padded on the right to 64 bits.
+	std::vector<uint64_t> first_codes;
+	/// Usage: `symbol_value_counts[symbol]`. The number of values that a symbol stands for, minus one.
+	std::vector<uint8_t> symbol_value_counts;
+	/// The pieces in the order that they are encoded.
+	uint8_t pieces[MAX_PIECES] = {};
+	/// Usage: `group_factors[group]`. The index of a position is the sum of each group's index times its factor. The entry after the last group is the number of indices.
+	uint64_t group_factors[MAX_PIECES + 1] = {};
+	/// Usage: `group_sizes[group]`. Pieces are encoded in groups of identical pieces, except that the first group holds the leading pawns or the first two or three pieces. Ends with `0`.
+	int group_sizes[MAX_PIECES + 1] = {};
+	/// Usage: `dtz_map_offsets[wdl_class]`. For DTZ tables with `HAS_DTZ_MAP`, where each class of values starts in `Table::dtz_map`.
+	uint16_t dtz_map_offsets[4] = {};
+	
+	inline int left_symbol(int symbol) const
+	{
+		const uint8_t *pair = symbol_pairs + 3 * symbol;
+		return ((pair[1] & 0xF) << 8) | pair[0];
+	}
+	inline int right_symbol(int symbol) const
+	{
+		const uint8_t *pair = symbol_pairs + 3 * symbol;
+		return (pair[2] << 4) | (pair[1] >> 4);
+	}
+	
+	/// Returns the value at `index`.
+	int decompress(uint64_t index) const
+	{
+		if (flags & HAS_SINGLE_VALUE)
+			return min_code_length;
+		
+		// Start from the nearest entry in the sparse index and walk to the block that holds `index`
+		const uint64_t k = index / span;
+		uint32_t block = read_little_endian<uint32_t>(sparse_index + 6 * k);
+		int offset = read_little_endian<uint16_t>(sparse_index + 6 * k + 4);
+		offset += (int)(index % span) - (int)(span / 2);
+		while (offset < 0)
+			offset += read_little_endian<uint16_t>(block_value_counts + 2 * --block) + 1;
+		while (offset > read_little_endian<uint16_t>(block_value_counts + 2 * block))
+			offset -= read_little_endian<uint16_t>(block_value_counts + 2 * block++) + 1;
+		
+		// Read codes until reaching the symbol that covers `offset`
+		const uint8_t *next_word = blocks + (uint64_t)block * block_size;
+		uint64_t buffer = read_big_endian<uint64_t>(next_word);
+		next_word += 8;
+		int buffer_size = 64;
+		int symbol;
+		while (true) {
+			int length = 0;
+			while (buffer < first_codes[length])
+				length++;
+			symbol = (int)((buffer - first_codes[length]) >> (64 - length - min_code_length));
+			symbol += read_little_endian<uint16_t>(first_symbols + 2 * length);
+			if (offset < symbol_value_counts[symbol] + 1)
+				break;
+			offset -= symbol_value_counts[symbol] + 1;
+			
+			length += min_code_length;
+			buffer <<= length;
+			buffer_size -= length;
+			if (buffer_size <= 32) {
+				buffer_size += 32;
+				buffer |= (uint64_t)read_big_endian<uint32_t>(next_word) << (64 - buffer_size);
+				next_word += 4;
+			}
+		}
+		
+		// Expand the symbol down to the single value at `offset`
+		while (symbol_value_counts[symbol]) {
+			const int left = left_symbol(symbol);
+			if (offset < symbol_value_counts[left] + 1)
+				symbol = left;
+			else {
+				offset -= symbol_value_counts[left] + 1;
+				symbol = right_symbol(symbol);
+			}
+		}
+		return left_symbol(symbol);
+	}
+};
+
+/// One `.rtbw` or `.rtbz` file. The fields that describe its material are set when the file is found, and the rest when it is mapped.
+struct Table
+{
+	TableType type;
+	std::string file_name;
+	/// The material with white as the stronger side, which is the side that the table is written for, and with the colors swapped.
+	MaterialKey key, mirrored_key;
+	int piece_count;
+	bool has_pawns;
+	/// Whether a player has a piece other than the king that is the only one of its kind. Such tables encode the kings together with that piece.
+	bool has_unique_pieces;
+	/// Usage: `pawn_counts[0]` for the player with the leading pawns, `pawn_counts[1]` for the other player. The leading pawns belong to the player with fewer pawns, if both have some.
+	int pawn_counts[2];
+	
+	std::atomic<bool> is_mapped{false};
+	/// `nullptr` if the file couldn't be mapped.
+	const uint8_t *mapping = nullptr;
+	size_t mapping_size = 0;
+	/// For DTZ tables, maps the stored values back to distances.
+	const uint8_t *dtz_map = nullptr;
+	/// Usage: `items[player_to_move][file]`. DTZ tables only store one player to move, and tables without pawns only need one file.
+	PairsData items[2][4];
+	
+	~Table()
+	{
+		if (mapping)
+			munmap((void *)mapping, mapping_size);
+	}
+	
+	inline PairsData &get(int player_to_move, int file)
+	{
+		return items[type == WDL_TABLE ? player_to_move : 0][has_pawns ? file : 0];
+	}
+};
+
+/// Both files of a table.
+struct TablePair
+{
+	Table wdl, dtz;
+};
+
+std::vector<std::string> directories;
+std::vector<std::unique_ptr<TablePair>> table_pairs;
+/// Finds a table by the `material_key` of a position, with either player as the stronger side.
+std::unordered_map<MaterialKey, TablePair *> tables_by_key;
+/// Held while a file is being mapped.
+std::mutex mapping_mutex;
+
+/// Sets up `table` from the name of its `.rtbw` file, like `KRPvKR`.
+void describe(Table &table, TableType type, const std::string &material)
+{
+	table.type = type;
+	table.file_name = material + (type == WDL_TABLE ? ".rtbw" : ".rtbz");
+	
+	int counts[2][PIECE_COUNT] = {};
+	int side = WHITE;
+	table.piece_count = 0;
+	for (char ch : material) {
+		if (ch == 'v') {
+			side = BLACK;
+			continue;
+		}
+		const Piece piece = ch == 'P' ? PAWN : ch == 'N' ? KNIGHT : ch == 'B' ? BISHOP : ch == 'R' ? ROOK : ch == 'Q' ? QUEEN : KING;
+		counts[side][piece]++;
+		table.piece_count++;
+	}
+	table.key = material_key(counts);
+	std::swap(counts[WHITE], counts[BLACK]);
+	table.mirrored_key = material_key(counts);
+	std::swap(counts[WHITE], counts[BLACK]);
+	
+	table.has_pawns = counts[WHITE][PAWN] || counts[BLACK][PAWN];
+	table.has_unique_pieces = false;
+	for (int player = WHITE; player <= BLACK; player++)
+		for (Piece piece = PAWN; piece <= QUEEN; piece++)
+			if (counts[player][piece] == 1)
+				table.has_unique_pieces = true;
+	const bool white_leads = !counts[BLACK][PAWN] || (counts[WHITE][PAWN] && counts[BLACK][PAWN] >= counts[WHITE][PAWN]);
+	table.pawn_counts[0] = counts[white_leads ? WHITE : BLACK][PAWN];
+	table.pawn_counts[1] = counts[white_leads ? BLACK : WHITE][PAWN];
+}
+
+/// Returns the first directory in which `file_name` exists, with the file name appended, or an empty string.
+std::string find_file(const std::string &file_name)
+{
+	for (const std::string &directory : directories) {
+		const std::string file_url = directory + "/" + file_name;
+		if (fruit::file_exists(file_url))
+			return file_url;
+	}
+	return "";
+}
+
+
+// MARK: - Setting Up Tables
+
+/// Splits the pieces into groups and works out the factor of each group.
+void set_groups(const Table &table, PairsData &data, const int order[2], int file)
+{
+	int group = 0;
+	int first_group_size = table.has_pawns ? 0 : table.has_unique_pieces ? 3 : 2;
+	data.group_sizes[group] = 1;
+	for (int index = 1; index < table.piece_count; index++) {
+		if (--first_group_size > 0 || data.pieces[index] == data.pieces[index - 1])
+			data.group_sizes[group]++;
+		else
+			data.group_sizes[++group] = 1;
+	}
+	data.group_sizes[++group] = 0;
+	const int group_count = group;
+	
+	// The groups are combined in the order that the table specifies: `order[0]` is the position of the first group and `order[1]` the position of the other player's pawns
+	const bool has_pawns_on_both_sides = table.has_pawns && table.pawn_counts[1];
+	int next_group = has_pawns_on_both_sides ? 2 : 1;
+	int free_squares = 64 - data.group_sizes[0] - (has_pawns_on_both_sides ? data.group_sizes[1] : 0);
+	uint64_t factor = 1;
+	for (int position = 0; next_group < group_count || position == order[0] || position == order[1]; position++) {
+		if (position == order[0]) {
+			data.group_factors[0] = factor;
+			factor *= table.has_pawns ? LEADING_PAWN_GROUP_SIZE[data.group_sizes[0]][file] : table.has_unique_pieces ? 31'332 : 462;
+		}
+		else if (position == order[1]) {
+			data.group_factors[1] = factor;
+			factor *= BINOMIAL[data.group_sizes[1]][48 - data.group_sizes[0]];
+		}
+		else {
+			data.group_factors[next_group] = factor;
+			factor *= BINOMIAL[data.group_sizes[next_group]][free_squares];
+			free_squares -= data.group_sizes[next_group++];
+		}
+	}
+	data.group_factors[group_count] = factor;
+}
+
+uint8_t set_symbol_value_count(PairsData &data, int symbol, std::vector<bool> &is_visited)
+{
+	is_visited[symbol] = true;
+	const int right = data.right_symbol(symbol);
+	if (right == 0xFFF)
+		return 0;
+	const int left = data.left_symbol(symbol);
+	// The symbols form a tree, so each child only needs to be visited once
+	if (!is_visited[left])
+		data.symbol_value_counts[left] = set_symbol_value_count(data, left, is_visited);
+	if (!is_visited[right])
+		data.symbol_value_counts[right] = set_symbol_value_count(data, right, is_visited);
+	return data.symbol_value_counts[left] + data.symbol_value_counts[right] + 1;
+}
+
+/// Reads the compression parameters of `data` and returns the position after them.
+const uint8_t *set_sizes(PairsData &data, const uint8_t *position)
+{
+	data.flags = *position++;
+	if (data.flags & HAS_SINGLE_VALUE) {
+		data.min_code_length = *position++;
+		return position;
+	}
+	
+	const uint64_t index_count = data.group_factors[std::find(data.group_sizes, data.group_sizes + MAX_PIECES, 0) - data.group_sizes];
+	data.block_size = (size_t)1 << *position++;
+	data.span = (size_t)1 << *position++;
+	data.sparse_index_size = (size_t)((index_count + data.span - 1) / data.span);
+	const uint8_t padding = *position++;
+	data.block_count = read_little_endian<uint32_t>(position);
+	position += 4;
+	// The padding keeps the sparse index from pointing past the end
+	data.block_value_counts_size = data.block_count + padding;
+	data.max_code_length = *position++;
+	data.min_code_length = *position++;
+	data.first_symbols = position;
+	
+	// Canonical Huffman codes of the same length are consecutive, and a code is shorter the higher its symbol. Work out the first code of each length from the first symbol of each length, starting from the longest.
+	const int length_count = data.max_code_length - data.min_code_length + 1;
+	data.first_codes.assign(length_count, 0);
+	for (int length = length_count - 2; length >= 0; length--)
+		data.first_codes[length] = (data.first_codes[length + 1] + read_little_endian<uint16_t>(data.first_symbols + 2 * length) - read_little_endian<uint16_t>(data.first_symbols + 2 * (length + 1))) / 2;
+	for (int length = 0; length < length_count; length++)
+		data.first_codes[length] <<= 64 - length - data.min_code_length;
+	position += 2 * length_count;
+	
+	const int symbol_count = read_little_endian<uint16_t>(position);
+	position += 2;
+	data.symbol_pairs = position;
+	data.symbol_value_counts.assign(symbol_count, 0);
+	std::vector<bool> is_visited(symbol_count);
+	for (int symbol = 0; symbol < symbol_count; symbol++)
+		if (!is_visited[symbol])
+			data.symbol_value_counts[symbol] = set_symbol_value_count(data, symbol, is_visited);
+	
+	return position + 3 * symbol_count + (symbol_count & 1);
+}
+
+/// Reads where each class of values starts in the DTZ map and returns the position after the map.
+const uint8_t *set_dtz_map(Table &table, const uint8_t *position, int file_count)
+{
+	table.dtz_map = position;
+	for (int file = 0; file < file_count; file++) {
+		PairsData &data = table.get(0, file);
+		if (!(data.flags & HAS_DTZ_MAP))
+			continue;
+		if (data.flags & HAS_WIDE_DTZ_MAP) {
+			position += (position - table.mapping) & 1;
+			for (int wdl_class = 0; wdl_class < 4; wdl_class++) {
+				data.dtz_map_offsets[wdl_class] = (uint16_t)((position - table.dtz_map) / 2 + 1);
+				position += 2 * read_little_endian<uint16_t>(position) + 2;
+			}
+		}
+		else {
+			for (int wdl_class = 0; wdl_class < 4; wdl_class++) {
+				data.dtz_map_offsets[wdl_class] = (uint16_t)(position - table.dtz_map + 1);
+				position += *position + 1;
+			}
+		}
+	}
+	return position + ((position - table.mapping) & 1);
+}
+
+/// Reads the layout of a freshly mapped file.
+void set_up(Table &table)
+{
+	// Skip the magic number and the flags
+	const uint8_t *position = table.mapping + 5;
+	
+	const int side_count = (table.type == WDL_TABLE && table.key != table.mirrored_key) ? 2 : 1;
+	const int file_count = table.has_pawns ? 4 : 1;
+	const bool has_pawns_on_both_sides = table.has_pawns && table.pawn_counts[1];
+	
+	for (int file = 0; file < file_count; file++) {
+		for (int side = 0; side < side_count; side++)
+			table.get(side, file) = PairsData();
+		
+		const int order[2][2] = {
+			{position[0] & 0xF, has_pawns_on_both_sides ? position[1] & 0xF : 0xF},
+			{position[0] >> 4, has_pawns_on_both_sides ? position[1] >> 4 : 0xF},
+		};
+		position += 1 + has_pawns_on_both_sides;
+		
+		for (int index = 0; index < table.piece_count; index++, position++)
+			for (int side = 0; side < side_count; side++)
+				table.get(side, file).pieces[index] = side ? *position >> 4 : *position & 0xF;
+		
+		for (int side = 0; side < side_count; side++)
+			set_groups(table, table.get(side, file), order[side], file);
+	}
+	position += (position - table.mapping) & 1;
+	
+	for (int file = 0; file < file_count; file++)
+		for (int side = 0; side < side_count; side++)
+			position = set_sizes(table.get(side, file), position);
+	
+	if (table.type == DTZ_TABLE)
+		position = set_dtz_map(table, position, file_count);
+	
+	for (int file = 0; file < file_count; file++) {
+		for (int side = 0; side < side_count; side++) {
+			PairsData &data = table.get(side, file);
+			data.sparse_index = position;
+			position += 6 * data.sparse_index_size;
+		}
+	}
+	for (int file = 0; file < file_count; file++) {
+		for (int side = 0; side < side_count; side++) {
+			PairsData &data = table.get(side, file);
+			data.block_value_counts = position;
+			position += 2 * data.block_value_counts_size;
+		}
+	}
+	for (int file = 0; file < file_count; file++) {
+		for (int side = 0; side < side_count; side++) {
+			// Blocks are aligned to 64 bytes
+			position = table.mapping + ((position - table.mapping + 63) & ~63);
+			PairsData &data = table.get(side, file);
+			data.blocks = position;
+			position += (uint64_t)data.block_count * data.block_size;
+		}
+	}
+}
+
+/// Maps `table` into memory the first time it is probed. Returns whether the table can be used.
+bool map(Table &table)
+{
+	if (table.is_mapped.load(std::memory_order_acquire))
+		return table.mapping;
+	
+	std::lock_guard<std::mutex> lock(mapping_mutex);
+	// Another thread may have mapped the table while this one was waiting
+	if (table.is_mapped.load(std::memory_order_relaxed))
+		return table.mapping;
+	
+	const std::string file_url = find_file(table.file_name);
+	const int file_descriptor = file_url.empty() ? -1 : open(file_url.c_str(), O_RDONLY);
+	if (file_descriptor != -1) {
+		struct stat file_status;
+		fstat(file_descriptor, &file_status);
+		// Every table ends with a 16 byte checksum after data that is padded to 64 bytes
+		if (file_status.st_size % 64 == 16) {
+			void *mapping = mmap(nullptr, file_status.st_size, PROT_READ, MAP_SHARED, file_descriptor, 0);
+			if (mapping != MAP_FAILED) {
+				madvise(mapping, file_status.st_size, MADV_RANDOM);
+				table.mapping = (const uint8_t *)mapping;
+				table.mapping_size = file_status.st_size;
+			}
+		}
+		close(file_descriptor);
+	}
+	
+	constexpr uint8_t MAGIC_NUMBERS[2][4] = {{0x71, 0xE8, 0x23, 0x5D}, {0xD7, 0x66, 0x0C, 0xA5}};
+	if (table.mapping && std::equal(MAGIC_NUMBERS[table.type], MAGIC_NUMBERS[table.type] + 4, table.mapping))
+		set_up(table);
+	else if (table.mapping) {
+		cout << fruit::debug_description(file_url) << " is not a Syzygy table" << endl;
+		munmap((void *)table.mapping, table.mapping_size);
+		table.mapping = nullptr;
+	}
+	
+	table.is_mapped.store(true, std::memory_order_release);
+	return table.mapping;
+}
+
+
+// MARK: - Probing
+
+/// Returns the value that `table` stores for `game`. DTZ tables also need the position's `wdl` to decode the value.
+int probe_table(const Game<CLASSIC> &game, Table &table, WDL wdl, ProbeResult &result)
+{
+	int squares[MAX_PIECES];
+	uint8_t pieces[MAX_PIECES];
+	int size = 0;
+	
+	// Tables are written with white as the stronger side, and tables with the same material on both sides only store white to move. Other positions are looked up with the colors swapped and the board flipped vertically.
+	const bool is_symmetric_with_black_to_move = table.key == table.mirrored_key && game.active_player == BLACK;
+	const bool is_black_stronger = material_key(game) != table.key;
+	const bool swaps_colors = is_symmetric_with_black_to_move || is_black_stronger;
+	const int color_flip = swaps_colors ? 8 : 0;
+	const int square_flip = swaps_colors ? 56 : 0;
+	const int player_to_move = swaps_colors ^ game.active_player;
+	
+	// Tables with pawns are split by the file of the leading pawn, after mirroring it onto files a ... d
+	Bitboard LEADING_PAWNS = 0;
+	int leading_pawn_count = 0;
+	int file = 0;
+	if (table.has_pawns) {
+		const uint8_t leading_piece = table.get(0, 0).pieces[0] ^ color_flip;
+		LEADING_PAWNS = game.PIECES[PAWN] & game.PLAYERS[(leading_piece & 8) ? BLACK : WHITE];
+		for (Bitboard P = LEADING_PAWNS; P; )
+			squares[size++] = pop_lsb(P) ^ square_flip;
+		leading_pawn_count = size;
+		std::swap(squares[0], *std::max_element(squares, squares + leading_pawn_count, [](int a, int b) {
+			return PAWN_INDEX[a] < PAWN_INDEX[b];
+		}));
+		file = std::min(file_of(squares[0]), 7 - file_of(squares[0]));
+	}
+	
+	if (table.type == DTZ_TABLE) {
+		const PairsData &data = table.get(0, file);
+		if ((data.flags & STORES_BLACK_TO_MOVE) != player_to_move && !(table.key == table.mirrored_key && !table.has_pawns)) {
+			result = WRONG_PLAYER_TO_MOVE;
+			return 0;
+		}
+	}
+	
+	for (Bitboard B = game.OCCUPIED ^ LEADING_PAWNS; B; ) {
+		const int square = pop_lsb(B);
+		squares[size] = square ^ square_flip;
+		pieces[size++] = table_piece(game.list[square], game.color_at_square(square_to_bitboard(square))) ^ color_flip;
+	}
+	
+	const PairsData &data = table.get(player_to_move, file);
+	
+	// Put the pieces in the order that the table encodes them
+	for (int index = leading_pawn_count; index < size - 1; index++) {
+		for (int other = index + 1; other < size; other++) {
+			if (data.pieces[index] == pieces[other]) {
+				std::swap(pieces[index], pieces[other]);
+				std::swap(squares[index], squares[other]);
+				break;
+			}
+		}
+	}
+	
+	// Mirror the board so that the first piece is on files a ... d
+	if (file_of(squares[0]) > 3)
+		for (int index = 0; index < size; index++)
+			squares[index] ^= 7;
+	
+	uint64_t index = 0;
+	if (table.has_pawns) {
+		index = LEADING_PAWN_INDEX[leading_pawn_count][squares[0]];
+		std::stable_sort(squares + 1, squares + leading_pawn_count, [](int a, int b) {
+			return PAWN_INDEX[a] < PAWN_INDEX[b];
+		});
+		for (int pawn = 1; pawn < leading_pawn_count; pawn++)
+			index += BINOMIAL[pawn][PAWN_INDEX[squares[pawn]]];
+	}
+	else {
+		// Without pawns, the board can also be flipped vertically and along the diagonal. Put the first piece on ranks 1 ... 4, and the first piece of the first group that is off the diagonal below it.
+		if (rank_of(squares[0]) > 3)
+			for (int index = 0; index < size; index++)
+				squares[index] ^= 56;
+		for (int piece = 0; piece < data.group_sizes[0]; piece++) {
+			if (!diagonal_offset(squares[piece]))
+				continue;
+			if (diagonal_offset(squares[piece]) > 0)
+				for (int other = piece; other < size; other++)
+					squares[other] = ((squares[other] >> 3) | (squares[other] << 3)) & 63;
+			break;
+		}
+		
+		if (table.has_unique_pieces) {
+			// The first three pieces are encoded together. Each square skips the squares taken by the pieces before it.
+			const int adjustment_1 = squares[1] > squares[0];
+			const int adjustment_2 = (squares[2] > squares[0]) + (squares[2] > squares[1]);
+			if (diagonal_offset(squares[0]))
+				index = (TRIANGLE_INDEX[squares[0]] * 63 + (squares[1] - adjustment_1)) * 62 + squares[2] - adjustment_2;
+			else if (diagonal_offset(squares[1]))
+				index = (6 * 63 + rank_of(squares[0]) * 28 + BELOW_DIAGONAL_INDEX[squares[1]]) * 62 + squares[2] - adjustment_2;
+			else if (diagonal_offset(squares[2]))
+				index = 6 * 63 * 62 + 4 * 28 * 62 + rank_of(squares[0]) * 7 * 28 + (rank_of(squares[1]) - adjustment_1) * 28 + BELOW_DIAGONAL_INDEX[squares[2]];
+			else
+				index = 6 * 63 * 62 + 4 * 28 * 62 + 4 * 7 * 28 + rank_of(squares[0]) * 7 * 6 + (rank_of(squares[1]) - adjustment_1) * 6 + (rank_of(squares[2]) - adjustment_2);
+		}
+		else
+			index = KING_PAIR_INDEX[TRIANGLE_INDEX[squares[0]]][squares[1]];
+	}
+	
+	// Encode the other groups, each as a combination of the squares that the earlier groups left free
+	index *= data.group_factors[0];
+	int *group_squares = squares + data.group_sizes[0];
+	bool has_remaining_pawns = table.has_pawns && table.pawn_counts[1];
+	for (int group = 1; data.group_sizes[group]; group++) {
+		std::stable_sort(group_squares, group_squares + data.group_sizes[group]);
+		uint64_t group_index = 0;
+		for (int piece = 0; piece < data.group_sizes[group]; piece++) {
+			const int adjustment = (int)std::count_if(squares, group_squares, [&](int square) {
+				return group_squares[piece] > square;
+			});
+			// The other player's pawns can't be on the first rank
+			group_index += BINOMIAL[piece + 1][group_squares[piece] - adjustment - (has_remaining_pawns ? 8 : 0)];
+		}
+		has_remaining_pawns = false;
+		index += group_index * data.group_factors[group];
+		group_squares += data.group_sizes[group];
+	}
+	
+	int value = data.decompress(index);
+	if (table.type == WDL_TABLE)
+		return value - 2;
+	
+	// DTZ values are stored by frequency within each class of WDL values, and the map restores them
+	constexpr int WDL_CLASSES[] = {1, 3, 0, 2, 0};
+	const PairsData &file_data = table.get(0, file);
+	if (file_data.flags & HAS_DTZ_MAP) {
+		const int offset = file_data.dtz_map_offsets[WDL_CLASSES[wdl + 2]] + value;
+		value = (file_data.flags & HAS_WIDE_DTZ_MAP) ? read_little_endian<uint16_t>(table.dtz_map + 2 * offset) : table.dtz_map[offset];
+	}
+	// Some tables count moves instead of plies
+	if ((wdl == WIN && !(file_data.flags & WINS_IN_PLIES)) || (wdl == LOSS && !(file_data.flags & LOSSES_IN_PLIES)) || wdl == CURSED_WIN || wdl == BLESSED_LOSS)
+		value *= 2;
+	return value + 1;
+}
+
+int probe_table(const Game<CLASSIC> &game, TableType type, WDL wdl, ProbeResult &result)
+{
+	// Two bare kings aren't stored
+	if (popcount(game.OCCUPIED) == 2)
+		return DRAW;
+	
+	const auto found = tables_by_key.find(material_key(game));
+	if (found == tables_by_key.end()) {
+		result = FAILED;
+		return 0;
+	}
+	Table &table = (type == WDL_TABLE) ? found->second->wdl : found->second->dtz;
+	if (!map(table)) {
+		result = FAILED;
+		return 0;
+	}
+	return probe_table(game, table, wdl, result);
+}
+
+inline bool is_capture(Move move)
+{
+	return move_captured_piece(move) || (move_piece(move) == PAWN && file_of(move_from(move)) != file_of(move_to(move)));
+}
+
+/// The tables don't store a meaningful value when the best move is a capture, or for DTZ tables a pawn move, so that the generator can pick whatever compresses best. They also don't know about en passant. Searching those moves first and taking the best of their values and the stored value fixes both.
+WDL search(Game<CLASSIC> &game, ProbeResult &result, bool includes_pawn_moves)
+{
+	WDL best_value = LOSS;
+	const std::vector<Move> moves = game.legal_moves();
+	int searched_move_count = 0;
+	for (Move move : moves) {
+		if (!is_capture(move) && (!includes_pawn_moves || move_piece(move) != PAWN))
+			continue;
+		searched_move_count++;
+		
+		game.apply(move);
+		const WDL value = (WDL)-search(game, result, false);
+		game.undo();
+		if (result == FAILED)
+			return DRAW;
+		
+		if (value > best_value) {
+			best_value = value;
+			if (value >= WIN) {
+				result = ZEROING_BEST_MOVE;
+				return value;
+			}
+		}
+	}
+	
+	// If every legal move was searched, the stored value may be wrong and isn't needed
+	const bool has_searched_every_move = searched_move_count && searched_move_count == (int)moves.size();
+	WDL value = best_value;
+	if (!has_searched_every_move) {
+		value = (WDL)probe_table(game, WDL_TABLE, DRAW, result);
+		if (result == FAILED)
+			return DRAW;
+	}
+	
+	if (best_value >= value) {
+		result = (best_value > DRAW || has_searched_every_move) ? ZEROING_BEST_MOVE : SUCCEEDED;
+		return best_value;
+	}
+	result = SUCCEEDED;
+	return value;
+}
+
+/// The distance to zeroing of a position whose best move is a zeroing move.
+inline int dtz_before_zeroing(WDL wdl)
+{
+	switch (wdl) {
+		case WIN:
+			return 1;
+		case CURSED_WIN:
+			return 101;
+		case BLESSED_LOSS:
+			return -101;
+		case LOSS:
+			return -1;
+		default:
+			return 0;
+	}
+}
+
+inline int sign(int value)
+{
+	return (value > 0) - (value < 0);
+}
+
+int probe_dtz(Game<CLASSIC> &game, ProbeResult &result)
+{
+	result = SUCCEEDED;
+	const WDL wdl = search(game, result, true);
+	// DTZ tables don't store draws
+	if (result == FAILED || wdl == DRAW)
+		return 0;
+	if (result == ZEROING_BEST_MOVE)
+		return dtz_before_zeroing(wdl);
+	
+	int dtz = probe_table(game, DTZ_TABLE, wdl, result);
+	if (result == FAILED)
+		return 0;
+	if (result != WRONG_PLAYER_TO_MOVE)
+		return (dtz + 100 * (wdl == BLESSED_LOSS || wdl == CURSED_WIN)) * sign(wdl);
+	
+	// The table stores the other player to move, so look one ply ahead for the move that keeps the value with the best distance
+	int best_dtz = INT_MAX;
+	for (Move move : game.legal_moves()) {
+		const bool is_zeroing = is_irreversible(move);
+		game.apply(move);
+		// For a zeroing move, the distance is counted from before the move
+		if (is_zeroing)
+			dtz = -dtz_before_zeroing(search(game, result, false));
+		else
+			dtz = -probe_dtz(game, result);
+		// A mate can't be beaten
+		if (dtz == 1 && game.is_check(game.active_player) && game.legal_moves().empty())
+			best_dtz = 1;
+		if (!is_zeroing)
+			dtz += sign(dtz);
+		if (dtz < best_dtz && sign(dtz) == sign(wdl))
+			best_dtz = dtz;
+		game.undo();
+		if (result == FAILED)
+			return 0;
+	}
+	// Without legal moves, the player to move is mated
+	return best_dtz == INT_MAX ? -1 : best_dtz;
+}
+
+} // namespace
+
+
+// MARK: - Interface
+
+int init(const std::string &paths)
+{
+	static std::once_flag has_initialized_indices;
+	std::call_once(has_initialized_indices, init_indices);
+	
+	tables_by_key.clear();
+	table_pairs.clear();
+	largest_table_size = 0;
+	directories.clear();
+	if (paths.empty() || paths == "<empty>")
+		return 0;
+	directories = fruit::split(paths, ':');
+	
+	// Every combination of up to five pieces besides the kings, strongest first on each side
+	std::vector<std::string> sides = {""};
+	for (size_t first = 0; first < sides.size(); first++) {
+		if (sides[first].size() == MAX_PIECES - 2)
+			continue;
+		for (char piece : std::string("QRBNP"))
+			if (sides[first].empty() || std::string("QRBNP").find(piece) >= std::string("QRBNP").find(sides[first].back()))
+				sides.push_back(sides[first] + piece);
+	}
+	
+	for (size_t first = 0; first < sides.size(); first++) {
+		for (size_t second = first; second < sides.size(); second++) {
+			if (sides[first].size() + sides[second].size() > MAX_PIECES - 2 || sides[first].size() + sides[second].size() == 0)
+				continue;
+			// The stronger side comes first in the file name, but which side that is depends on the generator's rules, so try both
+			for (const std::string &material : {"K" + sides[first] + "vK" + sides[second], "K" + sides[second] + "vK" + sides[first]}) {
+				if (find_file(material + ".rtbw").empty())
+					continue;
+				auto table_pair = std::make_unique<TablePair>();
+				describe(table_pair->wdl, WDL_TABLE, material);
+				describe(table_pair->dtz, DTZ_TABLE, material);
+				tables_by_key[table_pair->wdl.key] = table_pair.get();
+				tables_by_key[table_pair->wdl.mirrored_key] = table_pair.get();
+				largest_table_size = std::max(largest_table_size, table_pair->wdl.piece_count);
+				table_pairs.push_back(std::move(table_pair));
+				break;
+			}
+		}
+	}
+	return (int)table_pairs.size();
+}
+
+bool probe_wdl(Game<CLASSIC> &game, WDL &wdl)
+{
+	ProbeResult result = SUCCEEDED;
+	wdl = search(game, result, false);
+	return result != FAILED;
+}
+
+bool probe_dtz(Game<CLASSIC> &game, int &dtz)
+{
+	ProbeResult result;
+	dtz = probe_dtz(game, result);
+	return result != FAILED;
+}
+
+bool probe_root(Game<CLASSIC> &game, std::vector<Move> &moves, WDL &wdl)
+{
+	// Ranks are compared first: every move that wins in spite of the fifty move rule ranks the same, and so does every move that loses
+	constexpr int MAX_RANK = 1 << 18;
+	const int fifty_move_clock = game.fifty_move_rule_enabled ? game.reversible_move_clock : 0;
+	const bool has_repeated = game.is_two_move_repetition();
+	
+	struct RankedMove
+	{
+		Move move;
+		int rank;
+		int dtz;
+	};
+	std::vector<RankedMove> ranked_moves;
+	int best_rank = INT_MIN;
+	ProbeResult result = SUCCEEDED;
+	moves.clear();
+	for (Move move : game.legal_moves()) {
+		game.apply(move);
+		int dtz;
+		if (game.reversible_move_clock == 0) {
+			// Zeroing moves have distances of -101, -1, 0, 1 or 101
+			dtz = dtz_before_zeroing((WDL)-search(game, result, false));
+		}
+		else if (game.is_two_move_repetition() || game.is_fifty_move_draw()) {
+			dtz = 0;
+		}
+		else {
+			dtz = -probe_dtz(game, result);
+			dtz += sign(dtz);
+		}
+		// A mate is the fastest possible progress
+		if (dtz == 2 && game.is_check(game.active_player) && game.legal_moves().empty())
+			dtz = 1;
+		game.undo();
+		if (result == FAILED)
+			return false;
+		
+		int rank = 0;
+		if (!game.fifty_move_rule_enabled)
+			rank = sign(dtz) * MAX_RANK;
+		else if (dtz > 0)
+			rank = (dtz + fifty_move_clock <= 99 && !has_repeated) ? MAX_RANK : MAX_RANK - (dtz + fifty_move_clock);
+		else if (dtz < 0)
+			rank = (-dtz * 2 + fifty_move_clock < 100) ? -MAX_RANK : -MAX_RANK + (-dtz + fifty_move_clock);
+		
+		ranked_moves.push_back({ move, rank, dtz });
+		best_rank = std::max(best_rank, rank);
+	}
+	
+	// A winning player wants the lowest distance, and so does a losing player, whose distances are negative
+	std::stable_sort(ranked_moves.begin(), ranked_moves.end(), [](const RankedMove &a, const RankedMove &b) {
+		return a.dtz < b.dtz;
+	});
+	for (const RankedMove &ranked_move : ranked_moves)
+		if (ranked_move.rank == best_rank)
+			moves.push_back(ranked_move.move);
+	
+	if (best_rank >= MAX_RANK - 100)
+		wdl = WIN;
+	else if (best_rank > 0)
+		wdl = CURSED_WIN;
+	else if (best_rank <= -MAX_RANK + 100)
+		wdl = LOSS;
+	else if (best_rank < 0)
+		wdl = BLESSED_LOSS;
+	else
+		wdl = DRAW;
+	return true;
+}
+
+} // namespace Syzygy
@@ -0,0 +1,52 @@
+//
+//  syzygy.h
+//  Chaos Chess (Hummingbird)
+//
+//  Created by McKinley Keys on 10/19/26.
+//
+
+#pragma once
+#ifndef syzygy_h
+#define syzygy_h
+
+#include "fruit.h"
+#include "definitions.h"
+#include "bitboard.h"
+#include "game_def.h"
+
+/// Probes Syzygy endgame tablebases. The tables only describe standard chess, so they only apply to variants with `Variants::has_standard_rules`.
+///
+/// Each table is a pair of files: a `.rtbw` file with the win/draw/loss value of every position, and a `.rtbz` file with the distance to the next capture or pawn move ("zeroing" move) that keeps that value. Only the existence of the `.rtbw` files is checked up front; a file is mapped into memory the first time it is probed, so that unused tables cost nothing. Probing is thread safe.
+namespace Syzygy
+{
+
+/// Game-theoretic values from the point of view of the player to move. A cursed win is a win that the fifty move rule turns into a draw, and a blessed loss is a loss that the fifty move rule saves.
+enum WDL: int
+{
+	LOSS = -2, BLESSED_LOSS = -1, DRAW = 0, CURSED_WIN = 1, WIN = 2,
+};
+
+/// The number of pieces, kings included, in the largest table that was found, or `0` if there are no tables.
+extern int largest_table_size;
+
+/// Replaces the tables with the ones found in `paths`, a list of directories separated by colons. An empty list or `<empty>` removes all tables. Must not be called while a probe is running. Returns the number of tables found.
+int init(const std::string &paths);
+
+/// Returns whether the tables that were found cover `game`.
+inline bool can_probe(const AbstractGame &game)
+{
+	return largest_table_size && game.castling_rights == 0 && popcount(game.OCCUPIED) <= largest_table_size;
+}
+
+/// Sets `wdl` to the value of the position. Returns `false` if a table that is needed is missing or can't be read.
+bool probe_wdl(Game<CLASSIC> &game, WDL &wdl);
+/// Sets `dtz` to the number of plies until the next zeroing move, assuming that the winning side makes progress as fast as possible and the losing side resists as long as possible. The sign of `dtz` is the sign of the position's value, and a magnitude above `100` means that the result is cursed or blessed. Returns `false` if a table that is needed is missing or can't be read.
+///
+/// `dtz` can be one ply too high for positions where the zeroing move isn't the last move before a conversion.
+bool probe_dtz(Game<CLASSIC> &game, int &dtz);
+/// Sets `moves` to the root moves that keep the best value for the player to move, taking the fifty move rule into account. They are ordered so that a winning player makes progress as fast as possible and a losing player resists as long as possible. Sets `wdl` to the value that the moves keep. Returns `false` if a table that is needed is missing or can't be read.
+bool probe_root(Game<CLASSIC> &game, std::vector<Move> &moves, WDL &wdl);
+
+} // namespace Syzygy
+
+#endif /* syzygy_h */
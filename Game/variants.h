@@ -95,6 +95,12 @@ constexpr bool has_king_of_the_hill(Variant v)
 	return v == KING_OF_THE_HILL || v == KING_OF_THE_HILL_AND_COMPULSION;
 }
 
+/// Returns whether winning material is the main objective in `v`. Search heuristics that assume a side that is far ahead in material stays ahead are only sound in these variants.
+constexpr bool has_material_as_main_objective(Variant v)
+{
+	return !(v == LOSER || has_king_of_the_hill(v));
+}
+
 /// Returns whether `v` allows winning by capturing the opponent's king.
 constexpr bool has_win_by_king_capture(Variant v)
 {
@@ -107,6 +113,12 @@ constexpr bool has_destructive_moves(Variant v)
 	return v == EXPLODING_KNIGHTS;
 }
 
+/// Returns whether `v` plays by the standard rules of chess, so that endgame tablebases apply to it.
+constexpr bool has_standard_rules(Variant v)
+{
+	return v == CLASSIC;
+}
+
 } // namespace Variants
 
 //#define INSTANTIATE_TEMPLATE_CLASS_WITH_VARIANT(_, VARIANT, CLASS_NAME) template class CLASS_NAME<(Variant)VARIANT>;
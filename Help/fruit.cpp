@@ -395,4 +395,32 @@ void DispatchQueue::idle_loop()
 // https://codereview.stackexchange.com/questions/78771/c14-async-task-scheduler
 // https://stackoverflow.com/questions/11865460/issue-when-scheduling-tasks-using-clock-function?noredirect=1&lq=1
 
+
+// MARK: - Buffered Writer
+
+BufferedWriter::BufferedWriter(std::ostream &_stream) : stream(_stream)
+{
+	buffer.reserve(4096);
+}
+BufferedWriter::~BufferedWriter()
+{
+	flush();
+}
+
+void BufferedWriter::write_line(const std::string &line)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	buffer += line;
+	buffer += '\n';
+}
+void BufferedWriter::flush()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	if (buffer.size()) {
+		stream.write(buffer.data(), buffer.size());
+		buffer.clear();
+	}
+	stream.flush();
+}
+
 } // namespace fruit
@@ -19,6 +19,7 @@
 #include <sstream>
 #include <chrono>
 #include <thread>
+#include <mutex>
 
 using std::cin;
 using std::cout;
@@ -194,6 +195,27 @@ public:
 	void idle_loop();
 };
 
+
+// MARK: - Buffered Writer
+
+/// Collects lines of output and writes them to a stream in batches. Safe to use from multiple threads; lines are never interleaved.
+class BufferedWriter
+{
+private:
+	std::ostream &stream;
+	std::string buffer;
+	std::mutex mutex;
+	
+public:
+	BufferedWriter(std::ostream &_stream);
+	~BufferedWriter();
+	
+	/// Appends `line` and a newline to the buffer without flushing it.
+	void write_line(const std::string &line);
+	/// Writes the buffer to the stream and flushes the stream.
+	void flush();
+};
+
 } // namespace fruit
 
 #endif /* bits_h */
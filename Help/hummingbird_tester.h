@@ -100,6 +100,53 @@ void rigorous_test()
 	cout << "Total time: " << std::round(total_time * 100) / 100 << endl;
 }
 
+/// Searches each position twice with the same node budget and checks that both searches agree.
+template<Variant V>
+void node_budget_test()
+{
+	cout << "Performing node budget test..." << endl;
+	
+	std::vector<std::string> fens = {
+		"start",
+		"mango",
+		"kiwi",
+		"grape",
+	};
+	
+	SearchLimits limits;
+	limits.nodes = 200'000;
+	
+	Hummingbird<V> hummingbird;
+	bool is_deterministic = true;
+	
+	for (std::string fen : fens) {
+		
+		hummingbird.setup_fen(fen);
+		
+		Move moves[2];
+		uint64_t node_counts[2];
+		for (int run = 0; run < 2; run++) {
+			hummingbird.reset_tables();
+			const uint64_t start_node_count = hummingbird.node_count;
+			moves[run] = hummingbird.find_best_move(limits);
+			node_counts[run] = hummingbird.node_count - start_node_count;
+		}
+		
+		cout << fen << ": " << Notation::move_to_string(moves[0]) << " (" << fruit::thousands_separated_by_commas(node_counts[0]) << " nodes)";
+		if (moves[0] != moves[1] || node_counts[0] != node_counts[1]) {
+			cout << " but the second search returned " << Notation::move_to_string(moves[1]) << " (" << fruit::thousands_separated_by_commas(node_counts[1]) << " nodes)";
+			is_deterministic = false;
+		}
+		cout << endl;
+	}
+	cout << endl;
+	
+	if (is_deterministic)
+		cout << "All searches were deterministic" << endl;
+	else
+		cout << "Some searches were not deterministic" << endl;
+}
+
 template<Variant V>
 void puzzle_test()
 {
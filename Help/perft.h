@@ -12,6 +12,7 @@
 #include "fruit.h"
 #include "game.h"
 #include <cmath>
+#include <atomic>
 
 namespace Perft
 {
@@ -19,11 +20,14 @@ namespace Perft
 inline uint64_t skipped_nodes = 0;
 inline int max_depth;
 inline Table<PerftEntry> table(10'000'000);
+/// Set from another thread to make `divide` return early. The counts of a stopped run are incomplete, so they are not stored in the table.
+inline std::atomic<bool> stop_requested = false;
 
 template<Variant V>
 uint64_t perft(Game<V> &game, int depth)
 {
 	if (depth == max_depth) return 1;
+	if (stop_requested) return 0;
 	
 	// Check for alternative win
 	if constexpr (Variants::has_alternative_winning_condition(V)) {
@@ -61,6 +65,8 @@ uint64_t perft(Game<V> &game, int depth)
 			}
 		}
 	}
+	if (stop_requested)
+		return count;
 	
 	// Update the transposition table
 	{
@@ -97,6 +103,7 @@ std::map<std::string, uint64_t> divide(Game<V> &game, int depth)
 	
 	max_depth = depth;
 	skipped_nodes = 0;
+	stop_requested = false;
 	game.generate_quasilegal_moves();
 	std::vector<Move> moves = game.quasilegal_moves;
 	for (Move move : moves) {
@@ -104,6 +111,8 @@ std::map<std::string, uint64_t> divide(Game<V> &game, int depth)
 			uint64_t count = perft(game, 1);
 			branches[Notation::move_to_string(move)] = count;
 			game.undo();
+			if (stop_requested)
+				break;
 		}
 	}
 	return branches;
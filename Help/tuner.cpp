@@ -0,0 +1,511 @@
+//
+//  tuner.cpp
+//  Chaos Chess (Hummingbird)
+//
+//  Created by McKinley Keys on 10/19/26.
+//
+
+#include "tuner.h"
+#include "game.h"
+#include "hummingbird.h"
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+
+namespace Tuner
+{
+
+// MARK: - Parameters
+
+enum class Layout
+{
+	SCALAR, PAIR, ROW, BOARD, PHASED_ROWS
+};
+/// The phase of the game that a parameter applies to. With `BY_HALF`, the first half of a group applies to the middlegame and the second half to the endgame.
+enum class Taper
+{
+	NONE, MIDDLEGAME, ENDGAME, BY_HALF
+};
+
+struct ParameterGroup
+{
+	const char *name;
+	const char *dimensions;
+	const char *documentation;
+	Layout layout;
+	Taper taper;
+	const int *defaults;
+	int count;
+};
+
+/// In the order that the groups appear in `evaluation_parameters.h`.
+enum Group
+{
+	MATERIAL_MIDDLEGAME, MATERIAL_ENDGAME,
+	PAWN_TABLE, KNIGHT_TABLE, BISHOP_TABLE, ROOK_TABLE, QUEEN_TABLE, KING_TABLE_MIDDLEGAME, KING_TABLE_ENDGAME,
+	BISHOP_PAIR, MOBILITY, ATTACKED_PIECE, CASTLING_RIGHT,
+	PASSED_PAWN, DOUBLED_PAWN, ISOLATED_PAWN, DEFENDED_PAWN, KNIGHT_OUTPOST,
+	GROUP_COUNT
+};
+
+const ParameterGroup GROUPS[GROUP_COUNT] =
+{
+	{"MATERIAL_SCORES_MIDDLEGAME", "[PIECE_COUNT]", "Usage: `MATERIAL_SCORES_MIDDLEGAME[piece]`.", Layout::ROW, Taper::MIDDLEGAME, Magic::MATERIAL_SCORES_MIDDLEGAME, PIECE_COUNT},
+	{"MATERIAL_SCORES_ENDGAME", "[PIECE_COUNT]", "Usage: `MATERIAL_SCORES_ENDGAME[piece]`.", Layout::ROW, Taper::ENDGAME, Magic::MATERIAL_SCORES_ENDGAME, PIECE_COUNT},
+	{"PAWN_SCORES", "[64]", "Scores for white's pawns on each square, as seen with white at the bottom of the board; black's are mirrored. Added to the material score in both phases.", Layout::BOARD, Taper::NONE, Magic::PAWN_SCORES, 64},
+	{"KNIGHT_SCORES", "[64]", "Scores for white's knights on each square, as seen with white at the bottom of the board; black's are mirrored. Added to the material score in both phases.", Layout::BOARD, Taper::NONE, Magic::KNIGHT_SCORES, 64},
+	{"BISHOP_SCORES", "[64]", "Scores for white's bishops on each square, as seen with white at the bottom of the board; black's are mirrored. Added to the material score in both phases.", Layout::BOARD, Taper::NONE, Magic::BISHOP_SCORES, 64},
+	{"ROOK_SCORES", "[64]", "Scores for white's rooks on each square, as seen with white at the bottom of the board; black's are mirrored. Added to the material score in both phases.", Layout::BOARD, Taper::NONE, Magic::ROOK_SCORES, 64},
+	{"QUEEN_SCORES", "[64]", "Scores for white's queens on each square, as seen with white at the bottom of the board; black's are mirrored. Added to the material score in both phases.", Layout::BOARD, Taper::NONE, Magic::QUEEN_SCORES, 64},
+	{"KING_SCORES_MIDDLEGAME", "[64]", "Like `PAWN_SCORES`, but for the king in the middlegame only.", Layout::BOARD, Taper::MIDDLEGAME, Magic::KING_SCORES_MIDDLEGAME, 64},
+	{"KING_SCORES_ENDGAME", "[64]", "Like `PAWN_SCORES`, but for the king in the endgame only.", Layout::BOARD, Taper::ENDGAME, Magic::KING_SCORES_ENDGAME, 64},
+	{"BISHOP_PAIR_SCORE", "", "Applies to a player with at least two bishops.", Layout::SCALAR, Taper::NONE, &Magic::BISHOP_PAIR_SCORE, 1},
+	{"MOBILITY_SCORE", "", "Applies to each safe square that a piece can move to. See `AttackMaps::mobility`.", Layout::SCALAR, Taper::NONE, &Magic::MOBILITY_SCORE, 1},
+	{"ATTACKED_PIECE_SCORES", "[PIECE_COUNT]", "Usage: `ATTACKED_PIECE_SCORES[piece]`. Applies to each piece that the opponent attacks.", Layout::ROW, Taper::NONE, Magic::ATTACKED_PIECE_SCORES, PIECE_COUNT},
+	{"CASTLING_RIGHT_SCORE", "", "Applies to each castling right that a player still has.", Layout::SCALAR, Taper::NONE, &Magic::CASTLING_RIGHT_SCORE, 1},
+	{"PASSED_PAWN_SCORES", "[2][8]", "Usage: `PASSED_PAWN_SCORES[endgame][rank]`, where `rank` counts from the pawn owner's side of the board.", Layout::PHASED_ROWS, Taper::BY_HALF, &Magic::PASSED_PAWN_SCORES[0][0], 16},
+	{"DOUBLED_PAWN_SCORE", "[2]", "Usage: `DOUBLED_PAWN_SCORE[endgame]`. Applies to each pawn that has a friendly pawn in front of it.", Layout::PAIR, Taper::BY_HALF, Magic::DOUBLED_PAWN_SCORE, 2},
+	{"ISOLATED_PAWN_SCORE", "[2]", "Usage: `ISOLATED_PAWN_SCORE[endgame]`. Applies to each pawn with no friendly pawns on the adjacent files.", Layout::PAIR, Taper::BY_HALF, Magic::ISOLATED_PAWN_SCORE, 2},
+	{"DEFENDED_PAWN_SCORE", "[2]", "Usage: `DEFENDED_PAWN_SCORE[endgame]`. Applies to each pawn that a friendly pawn defends.", Layout::PAIR, Taper::BY_HALF, Magic::DEFENDED_PAWN_SCORE, 2},
+	{"KNIGHT_OUTPOST_SCORE", "", "Applies to each knight on an outpost square that a friendly pawn defends and no enemy pawn can ever attack.", Layout::SCALAR, Taper::NONE, &Magic::KNIGHT_OUTPOST_SCORE, 1},
+};
+
+/// Usage: `OFFSETS[group]`. The index of the group's first parameter. `OFFSETS[GROUP_COUNT]` is the number of parameters.
+const std::array<int, GROUP_COUNT + 1> OFFSETS = []
+{
+	std::array<int, GROUP_COUNT + 1> offsets = {};
+	for (int group = 0; group < GROUP_COUNT; group++)
+		offsets[group + 1] = offsets[group] + GROUPS[group].count;
+	return offsets;
+}();
+const int PARAMETER_COUNT = OFFSETS[GROUP_COUNT];
+
+static Taper taper_of(int parameter)
+{
+	int group = 0;
+	while (OFFSETS[group + 1] <= parameter)
+		group++;
+	if (GROUPS[group].taper != Taper::BY_HALF)
+		return GROUPS[group].taper;
+	return (parameter - OFFSETS[group] < GROUPS[group].count / 2) ? Taper::MIDDLEGAME : Taper::ENDGAME;
+}
+
+static std::vector<double> default_parameters()
+{
+	std::vector<double> parameters;
+	for (const ParameterGroup &group : GROUPS)
+		parameters.insert(parameters.end(), group.defaults, group.defaults + group.count);
+	return parameters;
+}
+
+
+// MARK: - Traces
+
+/// One parameter's share of a position's evaluation: `coefficient * parameters[parameter]`, from white's point of view.
+struct Term
+{
+	uint16_t parameter;
+	float coefficient;
+};
+
+struct Position
+{
+	uint32_t first_term;
+	uint16_t term_count;
+	/// The game result from white's point of view: `1` for a win, `0.5` for a draw and `0` for a loss.
+	float result;
+};
+
+/// Counts how often each parameter applies to a position. Reused from one position to the next, so that tracing doesn't allocate once it has warmed up.
+class Tracer
+{
+private:
+	std::vector<int> counts;
+	std::vector<int> touched_parameters;
+
+public:
+	Tracer() : counts(PARAMETER_COUNT)
+	{}
+	
+	inline void add(Group group, int index, int count)
+	{
+		const int parameter = OFFSETS[group] + index;
+		if (counts[parameter] == 0)
+			touched_parameters.push_back(parameter);
+		counts[parameter] += count;
+	}
+	
+	/// Appends the nonzero counts to `terms`, weighted by the phase of the game, and starts over.
+	inline void flush(int endgame_progress, std::vector<Term> &terms)
+	{
+		const float middlegame_weight = (float)endgame_progress / 24;
+		for (int parameter : touched_parameters) {
+			if (counts[parameter]) {
+				float weight = 1;
+				const Taper taper = taper_of(parameter);
+				if (taper == Taper::MIDDLEGAME)
+					weight = middlegame_weight;
+				else if (taper == Taper::ENDGAME)
+					weight = 1 - middlegame_weight;
+				if (weight != 0)
+					terms.push_back({(uint16_t)parameter, counts[parameter] * weight});
+			}
+			counts[parameter] = 0;
+		}
+		touched_parameters.clear();
+	}
+};
+
+/// Mirrors `Hummingbird<CLASSIC>::evaluate`. `verify_traces` checks that the two agree.
+static void trace(const Game<CLASSIC> &game, Tracer &tracer, std::vector<Term> &terms)
+{
+	const AttackMaps *attack_maps[] = {&game.attack_maps<WHITE>(), &game.attack_maps<BLACK>()};
+	
+	const Bitboard PAWNS[] = {game.PIECES[PAWN] & game.PLAYERS[WHITE], game.PIECES[PAWN] & game.PLAYERS[BLACK]};
+	const Bitboard PAWN_ATTACKS[] = {
+		shift<NORTH_EAST>(PAWNS[WHITE]) | shift<NORTH_WEST>(PAWNS[WHITE]),
+		shift<SOUTH_EAST>(PAWNS[BLACK]) | shift<SOUTH_WEST>(PAWNS[BLACK]),
+	};
+	Bitboard ATTACK_SPANS[2];
+	for (int player = WHITE; player <= BLACK; player++) {
+		const Bitboard FRONT_SPAN = (player == WHITE) ? fill<NORTH>(shift<NORTH>(PAWNS[player])) : fill<SOUTH>(shift<SOUTH>(PAWNS[player]));
+		ATTACK_SPANS[player] = shift<EAST>(FRONT_SPAN) | shift<WEST>(FRONT_SPAN);
+	}
+	
+	for (int player = WHITE; player <= BLACK; player++) {
+		const int sign = (player == WHITE) ? 1 : -1;
+		
+		// Material and piece-square scores
+		for (Bitboard B = game.PLAYERS[player]; B; ) {
+			const int square = pop_lsb(B);
+			const Piece piece = game.list[square];
+			const int table_square = (player == WHITE) ? (7 - square / 8) * 8 + square % 8 : square;
+			tracer.add(MATERIAL_MIDDLEGAME, piece, sign);
+			tracer.add(MATERIAL_ENDGAME, piece, sign);
+			if (piece == KING) {
+				tracer.add(KING_TABLE_MIDDLEGAME, table_square, sign);
+				tracer.add(KING_TABLE_ENDGAME, table_square, sign);
+			}
+			else
+				tracer.add((Group)(PAWN_TABLE + piece - PAWN), table_square, sign);
+		}
+		
+		// Pawn structure
+		for (Bitboard P = PAWNS[player]; P; ) {
+			const int square = pop_lsb(P);
+			const Bitboard S = square_to_bitboard(square);
+			const Bitboard FRONT = (player == WHITE) ? fill<NORTH>(shift<NORTH>(S)) : fill<SOUTH>(shift<SOUTH>(S));
+			const Bitboard ADJACENT_FILES = shift<EAST>(FILES[square]) | shift<WEST>(FILES[square]);
+			const int rank = (player == WHITE) ? square / 8 : 7 - square / 8;
+			if ((PAWNS[!player] & (FRONT | shift<EAST>(FRONT) | shift<WEST>(FRONT))) == 0) {
+				tracer.add(PASSED_PAWN, rank, sign);
+				tracer.add(PASSED_PAWN, 8 + rank, sign);
+			}
+			for (int endgame = false; endgame <= true; endgame++) {
+				if (PAWNS[player] & FRONT)
+					tracer.add(DOUBLED_PAWN, endgame, sign);
+				if ((PAWNS[player] & ADJACENT_FILES) == 0)
+					tracer.add(ISOLATED_PAWN, endgame, sign);
+				if (PAWN_ATTACKS[player] & S)
+					tracer.add(DEFENDED_PAWN, endgame, sign);
+			}
+		}
+		
+		const Bitboard OUTPOSTS = Magic::OUTPOST_RANKS[player] & attack_maps[player]->BY_PIECE[PAWN] & ~ATTACK_SPANS[!player];
+		tracer.add(KNIGHT_OUTPOST, 0, sign * popcount(game.PIECES[KNIGHT] & game.PLAYERS[player] & OUTPOSTS));
+		if (popcount(game.PIECES[BISHOP] & game.PLAYERS[player]) >= 2)
+			tracer.add(BISHOP_PAIR, 0, sign);
+		tracer.add(MOBILITY, 0, sign * attack_maps[player]->mobility);
+		const Bitboard ATTACKED_FRIENDLY = game.PLAYERS[player] & attack_maps[!player]->ALL;
+		for (Piece piece = PAWN; piece <= KING; piece++)
+			tracer.add(ATTACKED_PIECE, piece, sign * popcount(game.PIECES[piece] & ATTACKED_FRIENDLY));
+		tracer.add(CASTLING_RIGHT, 0, sign * (game.can_castle_kingside(player) + game.can_castle_queenside(player)));
+	}
+	
+	const int endgame_progress = std::min(game.piece_scores.endgame_progress[WHITE] + game.piece_scores.endgame_progress[BLACK], 24);
+	tracer.flush(endgame_progress, terms);
+}
+
+static inline double evaluate(const Position &position, const Term *terms, const std::vector<double> &parameters)
+{
+	double evaluation = 0;
+	for (const Term *term = terms + position.first_term; term < terms + position.first_term + position.term_count; term++)
+		evaluation += term->coefficient * parameters[term->parameter];
+	return evaluation;
+}
+
+static inline double sigmoid(double scaling, double evaluation)
+{
+	return 1 / (1 + std::pow(10, -scaling * evaluation / 400));
+}
+
+
+// MARK: - Loading
+
+/// Splits `[0, count)` into one contiguous range per thread and runs `body(begin, end, thread_index)` on each.
+static void parallel_for(int thread_count, size_t count, const std::function<void(size_t, size_t, int)> &body)
+{
+	std::vector<std::thread> threads;
+	for (int thread_index = 0; thread_index < thread_count; thread_index++) {
+		const size_t begin = count * thread_index / thread_count;
+		const size_t end = count * (thread_index + 1) / thread_count;
+		threads.emplace_back(body, begin, end, thread_index);
+	}
+	for (std::thread &thread : threads)
+		thread.join();
+}
+
+/// Reads the FEN and the result from one line of training data. Returns `false` if the line isn't a labelled position.
+static bool parse_line(const std::string &line, std::string &fen, float &result)
+{
+	const std::vector<std::string> fields = fruit::split(line, ' ');
+	if (fields.size() < 5)
+		return false;
+	fen = fields[0] + " " + fields[1] + " " + fields[2] + " " + fields[3];
+	
+	const size_t bracket = line.rfind('[');
+	if (bracket != std::string::npos) {
+		try {
+			result = std::stof(line.substr(bracket + 1));
+			return result >= 0 && result <= 1;
+		}
+		catch (...) {
+			return false;
+		}
+	}
+	if (line.find("1/2-1/2") != std::string::npos)
+		result = 0.5;
+	else if (line.find("1-0") != std::string::npos)
+		result = 1;
+	else if (line.find("0-1") != std::string::npos)
+		result = 0;
+	else
+		return false;
+	return true;
+}
+
+struct TrainingData
+{
+	std::vector<Position> positions;
+	std::vector<Term> terms;
+	/// A sample of the positions, for `verify_traces`.
+	std::vector<std::pair<std::string, size_t>> sample;
+};
+
+static TrainingData load(const std::string &data_url, int thread_count)
+{
+	const std::optional<std::string> contents = fruit::slurp(data_url);
+	if (!contents.has_value())
+		fruit::fatal_error("Failed to read tuning data " + fruit::debug_description(data_url));
+	const std::vector<std::string> lines = fruit::split(contents.value(), '\n');
+	
+	// Trace the positions in parallel, then stitch the per-thread results together
+	std::vector<TrainingData> parts(thread_count);
+	parallel_for(thread_count, lines.size(), [&](size_t begin, size_t end, int thread_index) {
+		TrainingData &part = parts[thread_index];
+		Game<CLASSIC> game;
+		Tracer tracer;
+		std::string fen;
+		float result = 0;
+		for (size_t index = begin; index < end; index++) {
+			if (!parse_line(lines[index], fen, result))
+				continue;
+			game.setup_fen(fen);
+			// Positions in check are rarely quiet enough for the static evaluation to judge
+			if (game.is_check(game.active_player))
+				continue;
+			const size_t first_term = part.terms.size();
+			trace(game, tracer, part.terms);
+			part.positions.push_back({(uint32_t)first_term, (uint16_t)(part.terms.size() - first_term), result});
+			if ((int)part.sample.size() < 1000 / thread_count + 1)
+				part.sample.emplace_back(fen, part.positions.size() - 1);
+		}
+	});
+	
+	TrainingData data;
+	for (TrainingData &part : parts) {
+		const uint32_t term_offset = (uint32_t)data.terms.size();
+		const size_t position_offset = data.positions.size();
+		for (Position &position : part.positions)
+			position.first_term += term_offset;
+		for (auto &[fen, index] : part.sample)
+			data.sample.emplace_back(fen, index + position_offset);
+		data.positions.insert(data.positions.end(), part.positions.begin(), part.positions.end());
+		data.terms.insert(data.terms.end(), part.terms.begin(), part.terms.end());
+		part = TrainingData();
+	}
+	return data;
+}
+
+/// Checks that the traces reproduce `Hummingbird<CLASSIC>::evaluate` with the current parameters, so that the tuner doesn't silently optimize a different function when the evaluation changes.
+static void verify_traces(const TrainingData &data)
+{
+	const std::vector<double> parameters = default_parameters();
+	auto hummingbird = std::make_unique<Hummingbird<CLASSIC>>();
+	int mismatch_count = 0;
+	for (const auto &[fen, index] : data.sample) {
+		hummingbird->game.setup_fen(fen);
+		int evaluation = hummingbird->evaluate(0);
+		if (hummingbird->game.active_player == BLACK)
+			evaluation = -evaluation;
+		// The evaluation rounds its tapered terms, the traces don't
+		if (std::abs(evaluation - evaluate(data.positions[index], data.terms.data(), parameters)) > 2) {
+			if (mismatch_count == 0)
+				cout << "(Warning) Traced evaluation differs from Hummingbird's for " << fen << endl;
+			mismatch_count++;
+		}
+	}
+	if (mismatch_count)
+		cout << "(Warning) " << mismatch_count << " of " << data.sample.size() << " sampled traces differ from Hummingbird's evaluation" << endl;
+}
+
+
+// MARK: - Optimization
+
+static double mean_squared_error(const TrainingData &data, const std::vector<double> &parameters, double scaling, int thread_count)
+{
+	std::vector<double> errors(thread_count);
+	parallel_for(thread_count, data.positions.size(), [&](size_t begin, size_t end, int thread_index) {
+		double error = 0;
+		for (size_t index = begin; index < end; index++) {
+			const Position &position = data.positions[index];
+			const double difference = position.result - sigmoid(scaling, evaluate(position, data.terms.data(), parameters));
+			error += difference * difference;
+		}
+		errors[thread_index] = error;
+	});
+	double error = 0;
+	for (double thread_error : errors)
+		error += thread_error;
+	return error / std::max<size_t>(data.positions.size(), 1);
+}
+
+/// Finds the sigmoid scaling that best fits the current parameters, by golden-section search.
+static double fit_scaling(const TrainingData &data, const std::vector<double> &parameters, int thread_count)
+{
+	const double ratio = (std::sqrt(5.0) - 1) / 2;
+	double low = 0, high = 4;
+	for (int iteration = 0; iteration < 40; iteration++) {
+		const double first = high - ratio * (high - low);
+		const double second = low + ratio * (high - low);
+		if (mean_squared_error(data, parameters, first, thread_count) < mean_squared_error(data, parameters, second, thread_count))
+			high = second;
+		else
+			low = first;
+	}
+	return (low + high) / 2;
+}
+
+void tune(const Settings &settings)
+{
+	const auto start_time = std::chrono::steady_clock::now();
+	const int thread_count = std::max(settings.thread_count, 1);
+	
+	cout << "Loading tuning data from " << fruit::debug_description(settings.data_url) << "..." << endl;
+	const TrainingData data = load(settings.data_url, thread_count);
+	cout << "Loaded " << fruit::thousands_separated_by_commas(data.positions.size()) << " positions with " << fruit::thousands_separated_by_commas(data.terms.size()) << " terms" << endl;
+	if (data.positions.empty())
+		return;
+	verify_traces(data);
+	
+	std::vector<double> parameters = default_parameters();
+	const double scaling = fit_scaling(data, parameters, thread_count);
+	cout << "Scaling: " << scaling << endl;
+	cout << "Initial error: " << mean_squared_error(data, parameters, scaling, thread_count) << endl;
+	
+	// Adam
+	constexpr double BETA_1 = 0.9, BETA_2 = 0.999, EPSILON = 1e-8;
+	std::vector<double> first_moments(PARAMETER_COUNT), second_moments(PARAMETER_COUNT);
+	std::vector<std::vector<double>> thread_gradients(thread_count, std::vector<double>(PARAMETER_COUNT));
+	
+	for (int epoch = 1; epoch <= settings.epoch_count; epoch++) {
+		
+		parallel_for(thread_count, data.positions.size(), [&](size_t begin, size_t end, int thread_index) {
+			std::vector<double> &gradient = thread_gradients[thread_index];
+			std::fill(gradient.begin(), gradient.end(), 0);
+			for (size_t index = begin; index < end; index++) {
+				const Position &position = data.positions[index];
+				const double prediction = sigmoid(scaling, evaluate(position, data.terms.data(), parameters));
+				// The derivative of the squared error, up to a constant factor that Adam makes irrelevant
+				const double slope = (prediction - position.result) * prediction * (1 - prediction);
+				for (const Term *term = data.terms.data() + position.first_term; term < data.terms.data() + position.first_term + position.term_count; term++)
+					gradient[term->parameter] += slope * term->coefficient;
+			}
+		});
+		
+		for (int parameter = 0; parameter < PARAMETER_COUNT; parameter++) {
+			double gradient = 0;
+			for (const std::vector<double> &thread_gradient : thread_gradients)
+				gradient += thread_gradient[parameter];
+			gradient /= data.positions.size();
+			first_moments[parameter] = BETA_1 * first_moments[parameter] + (1 - BETA_1) * gradient;
+			second_moments[parameter] = BETA_2 * second_moments[parameter] + (1 - BETA_2) * gradient * gradient;
+			const double first_moment = first_moments[parameter] / (1 - std::pow(BETA_1, epoch));
+			const double second_moment = second_moments[parameter] / (1 - std::pow(BETA_2, epoch));
+			parameters[parameter] -= settings.learning_rate * first_moment / (std::sqrt(second_moment) + EPSILON);
+		}
+		
+		if (epoch % 50 == 0 || epoch == settings.epoch_count)
+			cout << "Epoch " << epoch << ": error " << mean_squared_error(data, parameters, scaling, thread_count) << endl;
+	}
+	
+	write_parameters(parameters, settings.output_url);
+	const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+	cout << "Wrote " << fruit::debug_description(settings.output_url) << " after " << seconds << " seconds" << endl;
+}
+
+
+// MARK: - Output
+
+void write_parameters(const std::vector<double> &parameters, const std::string &file_url)
+{
+	std::ofstream file(file_url);
+	if (!file)
+		fruit::fatal_error("Failed to write " + fruit::debug_description(file_url));
+	
+	file << "//\n//  evaluation_parameters.h\n//  Chaos Chess (Hummingbird)\n//\n//  Generated by Tuner::write_parameters. The values can be edited by hand, but running the tuner rewrites the whole file.\n//\n\n";
+	file << "#pragma once\n#ifndef evaluation_parameters_h\n#define evaluation_parameters_h\n\n#include \"definitions.h\"\n\nnamespace Magic\n{\n";
+	
+	for (int group = 0; group < GROUP_COUNT; group++) {
+		const ParameterGroup &description = GROUPS[group];
+		std::vector<std::string> values;
+		for (int index = 0; index < description.count; index++)
+			values.push_back(std::to_string(std::lround(parameters[OFFSETS[group] + index])));
+		
+		file << "\n/// " << description.documentation << "\n";
+		file << "constexpr int " << description.name << description.dimensions << " =";
+		switch (description.layout) {
+			case Layout::SCALAR:
+				file << " " << values[0] << ";\n";
+				break;
+			case Layout::PAIR:
+				file << " {" << fruit::join(values, ", ") << "};\n";
+				break;
+			case Layout::ROW:
+				file << "\n{\n\t" << fruit::join(values, ", ") << "\n};\n";
+				break;
+			case Layout::BOARD:
+				file << "\n{\n";
+				for (int rank = 0; rank < 8; rank++) {
+					file << "\t";
+					for (int file_index = 0; file_index < 8; file_index++)
+						file << std::string(std::max(0, 3 - (int)values[rank * 8 + file_index].size()), ' ') << values[rank * 8 + file_index] << (file_index < 7 ? ", " : ",\n");
+				}
+				file << "};\n";
+				break;
+			case Layout::PHASED_ROWS: {
+				const int row_length = description.count / 2;
+				file << "\n{\n";
+				for (int row = 0; row < 2; row++)
+					file << "\t{" << fruit::join(std::vector<std::string>(values.begin() + row * row_length, values.begin() + (row + 1) * row_length), ", ") << "},\n";
+				file << "};\n";
+				break;
+			}
+		}
+	}
+	
+	file << "\n} // namespace Magic\n\n#endif /* evaluation_parameters_h */\n";
+}
+
+} // namespace Tuner
@@ -0,0 +1,40 @@
+//
+//  tuner.h
+//  Chaos Chess (Hummingbird)
+//
+//  Created by McKinley Keys on 10/19/26.
+//
+
+#pragma once
+#ifndef tuner_h
+#define tuner_h
+
+#include "fruit.h"
+#include <thread>
+
+/// Fits the parameters in `evaluation_parameters.h` to labelled positions (Texel tuning).
+///
+/// Each position is reduced once to a trace: how many times each parameter applies to white minus how many times it applies to black, plus the game phase. The hand-written evaluation is a linear function of its parameters, so each epoch only needs to evaluate these traces, and can split them across threads without allocating. The parameters are fitted by gradient descent on the squared error between the game results and a sigmoid of the evaluation.
+namespace Tuner
+{
+
+struct Settings
+{
+	/// A text file with one position per line: a FEN followed by the result from white's point of view, either as `1-0`, `0-1` and `1/2-1/2`, or as `[1.0]`, `[0.5]` and `[0.0]`.
+	std::string data_url;
+	/// Where to write the tuned `evaluation_parameters.h`.
+	std::string output_url;
+	int thread_count = std::max(1, (int)std::thread::hardware_concurrency());
+	int epoch_count = 1000;
+	/// The step size of the Adam optimizer, in centipawns.
+	double learning_rate = 1;
+};
+
+/// Tunes the classic variant's evaluation parameters and writes them to `settings.output_url`.
+void tune(const Settings &settings);
+/// Writes `parameters`, in the order that the tuner uses, as an `evaluation_parameters.h` header.
+void write_parameters(const std::vector<double> &parameters, const std::string &file_url);
+
+} // namespace Tuner
+
+#endif /* tuner_h */
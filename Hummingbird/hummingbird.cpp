@@ -32,14 +32,37 @@ constexpr int INF = INT_MAX;
 template<Variant V>
 Move Hummingbird<V>::find_best_move(int depth)
 {
-	fruit::Stopwatch stopwatch;
-	stopwatch.start();
+	SearchLimits limits;
+	limits.depth = depth;
+	return find_best_move(limits);
+}
+
+template<Variant V>
+Move Hummingbird<V>::find_best_move(int depth, double seconds)
+{
+	SearchLimits limits;
+	limits.depth = depth;
+	limits.move_time = seconds;
+	return find_best_move(limits);
+}
+
+template<Variant V>
+Move Hummingbird<V>::find_best_move(const SearchLimits &limits)
+{
+	const int depth = limits.depth;
+	time_manager.start(limits, game.active_player);
+	search_stopwatch.start();
+	ponder_move = NULL_MOVE;
+	search_start_node_count = node_count;
+	tablebase_hit_count = 0;
+	node_limit = limits.nodes ? node_count + limits.nodes : UINT64_MAX;
+	last_currmove_report = 0;
 	searching = true;
 	
 	// Check whether the game is finished
 	if (game.is_finished()) {
 		
-		cout << "(Warning) the game is finished according to Hummingbird's rule set";
+		std::string warning = "(Warning) the game is finished according to Hummingbird's rule set";
 		std::vector<std::string> reasons;
 		if (game.is_fifty_move_draw())
 			reasons.push_back("fifty move rule");
@@ -54,8 +77,12 @@ Move Hummingbird<V>::find_best_move(int depth)
 		if (game.is_stalemate())
 			reasons.push_back("stalemate");
 		if (reasons.size())
-			cout << " (" << fruit::join(reasons, ", ") << ")";
-		cout << endl;
+			warning += " (" + fruit::join(reasons, ", ") + ")";
+		report_warning(warning);
+		
+		wait_until_released(limits);
+		searching = false;
+		pondering = false;
 		
 		// Return any legal move
 		const std::vector<Move> moves = game.legal_moves();
@@ -67,28 +94,42 @@ Move Hummingbird<V>::find_best_move(int depth)
 		return ordered_moves.front().second;
 	}
 	
-	// Opening book
-	if (uses_opening_book) {
+	// Opening book. Book moves are chosen at random, so node-limited searches skip the book to stay reproducible. Pondering and infinite searches skip it because they must not return before they are told to.
+	if (uses_opening_book && !limits.is_deterministic() && !limits.ponder && !limits.infinite) {
 		
 		if (!opening_book.loaded)
-			cout << "(Warning) Hummingbird has no opening book" << endl;
+			report_warning("(Warning) Hummingbird has no opening book");
 		
 		Move move = opening_book.random_move(game);
 		if (move) {
 			searching = false;
-			searches_finished++;
 			return move;
 		}
 	}
 	
+	// Endgame tablebases. Only the root moves that keep the tablebase value are searched, so that the search can't give away a win or a draw, but still chooses between them. Several lines need every root move, so MultiPV doesn't use the tablebases at the root.
+	tablebase_root_moves.clear();
+	std::optional<int> tablebase_root_score;
+	if constexpr (Variants::has_standard_rules(V)) {
+		if (multi_pv == 1 && Syzygy::can_probe(game)) {
+			Syzygy::WDL wdl;
+			if (Syzygy::probe_root(game, tablebase_root_moves, wdl)) {
+				tablebase_hit_count++;
+				tablebase_root_score = tablebase_score(wdl);
+			}
+		}
+	}
+	
 	table_is_empty = false;
 	
-	if (!searching) {
-		cout << "Exiting early because searching is false" << endl;
-		exit(3);
-	}
+	// Killers are found at a ply from the root, so they don't carry over to a search from a different root
+	for (SearchFrame &frame : search_stack)
+		frame.killers[0] = frame.killers[1] = NULL_MOVE;
 	
 	Move previous_best_move = NULL_MOVE;
+	std::vector<Move> best_variation;
+	// The lines found by the previous iteration, best first
+	std::vector<RootLine> previous_lines;
 	int current_depth = 1;
 	do {
 		
@@ -96,41 +137,154 @@ Move Hummingbird<V>::find_best_move(int depth)
 			current_depth = std::min(current_depth, depth);
 		
 		max_depth = current_depth;
-		const std::pair<int, Move> result = search(0, -INF, INF, previous_best_move);
+		selective_depth = 0;
+		
+		// Search the root once per line, excluding the root moves of the lines that were already found. All lines share the transposition table.
+		std::vector<RootLine> lines;
+		for (int line_index = 0; line_index < multi_pv; line_index++) {
+			
+			// Follow the principal variation that this line had in the previous iteration
+			hint_variation.clear();
+			if (line_index < (int)previous_lines.size() && !fruit::contains(excluded_root_moves, previous_lines[line_index].principal_variation.front()))
+				hint_variation = previous_lines[line_index].principal_variation;
+			Move hint = hint_variation.empty() ? NULL_MOVE : hint_variation.front();
+			
+			// Search with a narrow window around the score that this line had in the previous iteration, and widen it until the score falls inside it
+			int window = ASPIRATION_WINDOW;
+			int center = 0;
+			int alpha = -INF;
+			int beta = INF;
+			if (current_depth >= ASPIRATION_MIN_DEPTH && line_index < (int)previous_lines.size() && std::abs(previous_lines[line_index].score) < CHECKMATE_SCORE - MAX_PLY) {
+				center = previous_lines[line_index].score;
+				alpha = center - window;
+				beta = center + window;
+			}
+			std::pair<int, Move> result;
+			while (true) {
+				root_move_number = 0;
+				result = search(0, alpha, beta, hint);
+				if (!searching)
+					break;
+				
+				window *= 2;
+				if (result.first <= alpha && alpha > -INF) {
+					// Failed low: every move is worse than we expected. Give the search more time to find a better move.
+					if (line_index == 0)
+						time_manager.root_failed_low();
+					alpha = window > ASPIRATION_MAX_WINDOW ? -INF : center - window;
+				}
+				else if (result.first >= beta && beta < INF) {
+					// Failed high: the move that caused the cutoff is the first one to try when searching again
+					hint = result.second;
+					beta = window > ASPIRATION_MAX_WINDOW ? INF : center + window;
+				}
+				else
+					break;
+			}
+			
+			// If the search exited early because it ran out of time, we can't trust the return value
+			if (!searching)
+				break;
+			// Every root move already has a line
+			if (result.second == NULL_MOVE)
+				break;
+			
+			const SearchFrame &root_frame = search_stack[0];
+			std::vector<Move> variation(root_frame.principal_variation, root_frame.principal_variation + root_frame.principal_variation_length);
+			if (variation.empty() || variation.front() != result.second)
+				variation = { result.second };
+			lines.push_back({ result.first, variation });
+			excluded_root_moves.push_back(result.second);
+		}
+		excluded_root_moves.clear();
 		
-		// If the search exited early because it ran out of time, we can't trust the return value
+		// The first line searches every root move, so its move is the best move even if the other lines didn't finish
+		if (lines.size()) {
+			previous_best_move = lines.front().principal_variation.front();
+			best_variation = lines.front().principal_variation;
+		}
 		if (!searching)
 			break;
 		
-		previous_best_move = result.second;
+		// A later line can score higher than an earlier one when the transposition table gives it a better bound
+		std::stable_sort(lines.begin(), lines.end(), [](const RootLine &a, const RootLine &b) {
+			return a.score > b.score;
+		});
+		previous_lines = lines;
+		previous_best_move = lines.front().principal_variation.front();
+		best_variation = lines.front().principal_variation;
+		
+		for (int line_index = 0; line_index < (int)lines.size(); line_index++) {
+			// The search only sees the tablebase value of the root through its leaves, so report it unless the search found a mate
+			int score = lines[line_index].score;
+			if (tablebase_root_score && std::abs(score) < CHECKMATE_SCORE - MAX_PLY)
+				score = *tablebase_root_score;
+			report_iteration(score, lines[line_index].principal_variation, line_index + 1);
+		}
+		if (info_output)
+			info_output->flush();
+		time_manager.iteration_finished(previous_best_move, lines.front().score);
+		check_time();
+		
+		// Stop early if one root move is far ahead of the others. When analyzing several lines, or without a time limit, every line should be searched deeply.
+		if (multi_pv == 1 && !limits.infinite && !pondering && time_manager.should_check_easy_move() && is_easy_move(previous_best_move, lines.front().score))
+			break;
 		
 		current_depth++;
 	}
-	while (searching && (current_depth <= depth || depth == 0));
+	while (searching && (current_depth <= depth || depth == 0) && current_depth < MAX_PLY && time_manager.should_start_iteration());
+	
+	// The search may have reached its depth limit or `MAX_PLY` before it was allowed to return
+	wait_until_released(limits);
 	
 	searching = false;
-	searches_finished++;
+	pondering = false;
+	
+	// The search can be stopped before it finishes its first iteration. Fall back to the best tablebase move, or else the move that looks best.
+	if (previous_best_move == NULL_MOVE && !tablebase_root_moves.empty())
+		previous_best_move = tablebase_root_moves.front();
+	tablebase_root_moves.clear();
+	if (previous_best_move == NULL_MOVE) {
+		const std::vector<Move> moves = game.legal_moves();
+		if (moves.size()) {
+			std::vector<std::pair<int, Move>> ordered_moves;
+			sort_moves(moves, ordered_moves);
+			previous_best_move = ordered_moves.front().second;
+		}
+	}
+	
+	// Expect the opponent to play the second move of the principal variation
+	if (best_variation.size() >= 2 && best_variation.front() == previous_best_move)
+		ponder_move = best_variation[1];
 	
 	// Print a warning if the move we chose is actually illegal
 	if (previous_best_move != NULL_MOVE && !fruit::contains(game.legal_moves(), previous_best_move))
-		cout << "(Warning) Hummingbird chose illegal move " << fruit::debug_description(Notation::move_to_string(previous_best_move)) << endl;
+		report_warning("(Warning) Hummingbird chose illegal move " + fruit::debug_description(Notation::move_to_string(previous_best_move)));
 	
 	return previous_best_move;
 }
 
-template<Variant V>
-Move Hummingbird<V>::find_best_move(int depth, double seconds)
-{
-	stop_after(seconds);
-	return find_best_move(depth);
-}
-
 // TODO: CONSIDER CHANGING RETURN TYPE TO uint64_t
 // TODO: PERHAPS ADD template<Color PLAYER>?
 template<Variant V>
-std::pair<int, Move> Hummingbird<V>::search(int depth, int alpha, int beta, Move hint)
+std::pair<int, Move> Hummingbird<V>::search(int depth, int alpha, int beta, Move hint, int extension)
 {
+	// Stop when the node budget runs out, before this node counts towards it
+	if (node_count >= node_limit) {
+		searching = false;
+		return { alpha, NULL_MOVE };
+	}
 	node_count++;
+	if (depth > selective_depth)
+		selective_depth = depth;
+	
+	SearchFrame &frame = search_stack[depth];
+	frame.principal_variation_length = depth;
+	frame.static_evaluation = NO_EVALUATION;
+	
+	// Poll the clock every so often
+	if ((node_count & 1023) == 0)
+		check_time();
 	
 	// Check for alternative win
 	if constexpr (Variants::has_alternative_winning_condition(V)) {
@@ -140,56 +294,66 @@ std::pair<int, Move> Hummingbird<V>::search(int depth, int alpha, int beta, Move
 			return { -checkmate_score(depth), NULL_MOVE };
 	}
 	// Check for draw
-	if (game.is_fifty_move_draw() || game.is_three_move_repetition()) {
-		if (depth == 0) {
-			if (game.is_fifty_move_draw())
-				cout << "Drawing at depth 0 from fifty move rule" << endl;
-			if (game.is_three_move_repetition())
-				cout << "Drawing at depth 0 from three-move repetition" << endl;
-		}
+	if (game.is_fifty_move_draw() || game.is_three_move_repetition())
 		return { std::max(alpha, 0), NULL_MOVE };
-	}
+	
+	// Mate distance pruning: no line from here can be better than mating on the next ply, or worse than being mated right now
+	alpha = std::max(alpha, -checkmate_score(depth));
+	beta = std::min(beta, checkmate_score(depth + 1));
+	if (alpha >= beta)
+		return { alpha, NULL_MOVE };
 	
 	const int initial_alpha = alpha;
+	const bool is_principal_variation_node = alpha + 1 < beta;
+	
+	// Extensions move the horizon of this path further away
+	int horizon = horizon_for(extension);
+	int remaining_depth = horizon - depth;
 	
 	bool has_legal_moves = false;
 	Move best_move = NULL_MOVE;
 	
+	// When some moves are excluded, the result isn't valid for the position as a whole, so the transposition table can't be used
+	const bool is_excluding_moves = (depth == 0 && (!excluded_root_moves.empty() || !tablebase_root_moves.empty())) || frame.excluded_move != NULL_MOVE;
+	
 	// Look up the position in the transposition table
 	Move hash_move = NULL_MOVE;
 	bool should_skip_hash_move = false;
-	{
-		const HummingbirdEntry *entry = table.get(game.hash);
+	const HummingbirdEntry *entry = nullptr;
+	if (!is_excluding_moves) {
+		entry = table.get(game.hash);
 		if (entry && !game.is_two_move_repetition()) {
 			
-			if (entry->remaining_depth >= max_depth - depth) {
+			const int entry_score = score_from_table(entry->score, depth);
+			
+			// Nodes searched with a full window don't use the scores in the table, so that their principal variation isn't cut short
+			if (entry->remaining_depth >= remaining_depth && !is_principal_variation_node) {
 				switch (entry->precision) {
 					
 					case HummingbirdEntry::EXACT:
-						if (depth == 0 && entry->best_move == NULL_MOVE)
-							cout << "Returning null at depth 0 from transposition table";
-						return { entry->score, entry->best_move };
+						set_principal_variation(depth, entry->best_move);
+						return { entry_score, entry->best_move };
 					
 					case HummingbirdEntry::LOWER_BOUND:
-//						alpha = std::max(alpha, entry->score);
-						if (entry->score > alpha) {
-							alpha = entry->score;
+//						alpha = std::max(alpha, entry_score);
+						if (entry_score > alpha) {
+							alpha = entry_score;
 							best_move = entry->best_move;
+							set_principal_variation(depth, best_move);
 							has_legal_moves = true;
 							should_skip_hash_move = true;
 						}
 						break;
 					
 					case HummingbirdEntry::UPPER_BOUND:
-						beta = std::min(beta, entry->score);
+						beta = std::min(beta, entry_score);
 						break;
 					
 					case HummingbirdEntry::NONE:
 						break;
 				}
 				if (alpha >= beta) {
-					if (depth == 0 && entry->best_move == NULL_MOVE)
-						cout << "Returning null at depth 0 from transposition table because of beta cutoff" << endl;
+					set_principal_variation(depth, entry->best_move);
 					return { alpha, entry->best_move };
 				}
 			}
@@ -197,12 +361,96 @@ std::pair<int, Move> Hummingbird<V>::search(int depth, int alpha, int beta, Move
 		}
 	}
 	
+	// Endgame tablebases. Their values are exact, but ignore the fifty move clock, so they are only probed right after it was reset. The root is left to `find_best_move`, which restricts the root moves instead.
+	if constexpr (Variants::has_standard_rules(V)) {
+		if (depth > 0 && !is_excluding_moves && game.reversible_move_clock == 0 && Syzygy::can_probe(game)) {
+			Syzygy::WDL wdl;
+			if (Syzygy::probe_wdl(game, wdl)) {
+				tablebase_hit_count++;
+				return { std::clamp(tablebase_score(wdl), alpha, beta), NULL_MOVE };
+			}
+		}
+	}
+	
+	// Without a hash move, the moves here would be searched in a poor order
+	if (!hash_move && !is_excluding_moves && depth > 0 && remaining_depth >= INTERNAL_ITERATIVE_MIN_DEPTH) {
+		if (uses_internal_iterative_deepening && is_principal_variation_node) {
+			// Internal iterative deepening: find a hash move with a shallower search first
+			hash_move = search(depth, alpha, beta, NULL_MOVE, extension - INTERNAL_ITERATIVE_DEEPENING_REDUCTION).second;
+			if (!searching)
+				return { alpha, best_move };
+			set_principal_variation(depth, best_move);
+		}
+		else {
+			// Internal iterative reduction: search this node a ply shallower. It stores a hash move that the next iteration can use.
+			extension--;
+			horizon = horizon_for(extension);
+			remaining_depth = horizon - depth;
+		}
+	}
+	
 	// Leaf node
-	if (depth == max_depth) {
+	if (depth >= horizon) {
 		leaf_node_count++;
-		if (depth == 0)
-			cout << "Returning null at depth 0 at leaf node" << endl;
-		return { evaluate(depth), NULL_MOVE };
+		return { cached_evaluate(depth, alpha, beta), NULL_MOVE };
+	}
+	
+	// Pruning near the horizon based on the static evaluation. This assumes that a side that is far ahead in material stays ahead, which only holds in variants where material is what matters.
+	bool is_in_check = false;
+	if constexpr (!Variants::has_check_disabled(V))
+		is_in_check = game.is_check(game.active_player);
+	bool is_futile = false;
+	if constexpr (Variants::has_material_as_main_objective(V)) {
+		if (depth > 0 && !is_principal_variation_node && remaining_depth <= futility_depth && std::abs(beta) < CHECKMATE_SCORE - MAX_PLY && !is_in_check) {
+			
+			frame.static_evaluation = cached_evaluate(depth);
+			const int static_evaluation = frame.static_evaluation;
+			
+			// Reverse futility pruning: we are so far ahead that the opponent is unlikely to catch up before the horizon
+			if (static_evaluation - reverse_futility_margin * remaining_depth >= beta)
+				return { beta, NULL_MOVE };
+			
+			// Razoring: we are so far behind that only a capture could help, and there is no quiescence search to find one, so settle for the static evaluation
+			if (remaining_depth <= razoring_depth && static_evaluation + razoring_margin * remaining_depth <= alpha)
+				return { alpha, NULL_MOVE };
+			
+			// Futility pruning: quiet moves are unlikely to raise alpha
+			is_futile = static_evaluation + futility_margin * remaining_depth <= alpha;
+		}
+	}
+	
+	// Each path may extend its horizon by at most `max_depth` plies, so that extensions can't make the search explode
+	const bool can_extend = extension < max_depth && horizon < MAX_PLY - 1;
+	
+	// Single reply extension: a position with only one legal move is forcing, so the move shouldn't count against the depth. Checking this is only worth it in check, and in variants where captures or checks are forced.
+	bool has_single_reply = false;
+	bool has_legal_moves_in_frame = false;
+	if (can_extend && (is_in_check || Variants::has_forced_capture_enabled(V) || Variants::has_forced_check_enabled(V))) {
+		game.legal_moves(frame.legal_moves);
+		has_legal_moves_in_frame = true;
+		has_single_reply = frame.legal_moves.size() == 1;
+	}
+	
+	// Singular extension: if every other move scores well below the hash move in a reduced search, the hash move is the only good move here and is searched deeper. This needs the table entry that the hash move came from, which internal iterative deepening doesn't provide.
+	Move singular_move = NULL_MOVE;
+	if (can_extend && !has_single_reply && depth > 0 && hash_move && entry && hash_move == entry->best_move && remaining_depth >= SINGULAR_MIN_DEPTH && frame.excluded_move == NULL_MOVE) {
+		if (entry->remaining_depth >= remaining_depth - 3 && (entry->precision == HummingbirdEntry::LOWER_BOUND || entry->precision == HummingbirdEntry::EXACT) && std::abs(entry->score) < CHECKMATE_SCORE - MAX_PLY) {
+			
+			const int singular_beta = entry->score - SINGULAR_MARGIN * remaining_depth;
+			const int reduction = remaining_depth / 2;
+			
+			frame.excluded_move = hash_move;
+			const int score = search(depth, singular_beta - 1, singular_beta, NULL_MOVE, extension - reduction).first;
+			frame.excluded_move = NULL_MOVE;
+			
+			if (!searching)
+				return { alpha, best_move };
+			if (score < singular_beta)
+				singular_move = hash_move;
+			
+			// The reduced search used the same principal variation row
+			set_principal_variation(depth, best_move);
+		}
 	}
 //	if (!searching) {
 //		return { alpha, 0 };
@@ -214,9 +462,9 @@ std::pair<int, Move> Hummingbird<V>::search(int depth, int alpha, int beta, Move
 	Move move_to_play;
 	int goto_origin;
 	
-	std::vector<Move> moves;
 	int move_index = 0;
-	std::vector<std::pair<int, Move>> ordered_moves;
+	frame.ordered_move_count = 0;
+	frame.quiet_move_count = 0;
 	
 	// Trials
 	{
@@ -228,72 +476,72 @@ std::pair<int, Move> Hummingbird<V>::search(int depth, int alpha, int beta, Move
 			hint_move_origin:
 			if (alpha >= beta)
 				goto trials_end;
-			if (!searching) {
-				if (depth == 0 && best_move == NULL_MOVE)
-					cout << "Returning null at depth 0 from hint move" << endl;
+			if (!searching)
 				return { alpha, best_move };
-			}
 		}
-		if (hash_move && !should_skip_hash_move) {
+		if (hash_move && hash_move != hint && !should_skip_hash_move) {
 			move_to_play = hash_move;
 			goto_origin = 1;
 			goto play_move;
 			hash_move_origin:
 			if (alpha >= beta)
 				goto trials_end;
-			if (!searching) {
-				if (depth == 0 && best_move == NULL_MOVE)
-					cout << "Returning null at depth 0 from hash move" << endl;
+			if (!searching)
 				return { alpha, best_move };
-			}
-		}
-		
-		if constexpr (Variants::has_forced_capture_enabled(V) || Variants::has_forced_check_enabled(V)) {
-			// These variants have special rules about what moves are legal
-			moves = game.legal_moves();
-		}
-		else {
-			game.generate_quasilegal_moves();
-			// TODO: AVOID COPYING
-			moves = game.quasilegal_moves;
-		}
-		// Remove `hint` and `hash_move` from `moves`
-		if (hint) {
-			const auto index = std::find(moves.begin(), moves.end(), hint);
-			if (index != moves.end())
-				moves.erase(index);
-			// TODO: CHECK WHETHER `moves.erase(hint)` is faster
-		}
-		if (hash_move) {
-			const auto index = std::find(moves.begin(), moves.end(), hash_move);
-			if (index != moves.end())
-				moves.erase(index);
 		}
 		
-		ordered_moves.reserve(moves.size());
-		for (Move move : moves) {
+		{
+			const std::vector<Move> *moves;
+			if constexpr (Variants::has_forced_capture_enabled(V) || Variants::has_forced_check_enabled(V)) {
+				// These variants have special rules about what moves are legal
+				if (!has_legal_moves_in_frame)
+					game.legal_moves(frame.legal_moves);
+				moves = &frame.legal_moves;
+			}
+			else {
+				game.generate_quasilegal_moves();
+				moves = &game.quasilegal_moves;
+			}
 			
-			int value = 0;
-			value += Magic::PIECE_SCORES[false][game.active_player][move_piece(move)][move_to(move)];
-			value -= Magic::PIECE_SCORES[false][game.active_player][move_piece(move)][move_from(move)];
-			value += Magic::PIECE_SCORES[false][!game.active_player][move_captured_piece(move)][move_to(move)];
+			// Quiet moves are also ordered by killers and by how well they worked in reply to the last two moves
+			const Move previous_move = depth >= 1 ? search_stack[depth - 1].move : NULL_MOVE;
+			const Move earlier_move = depth >= 2 ? search_stack[depth - 2].move : NULL_MOVE;
+			const Move counter_move = counter_moves.get(game.active_player, previous_move);
 			
-			ordered_moves.emplace_back(-value, move);
+			for (Move move : *moves) {
+				
+				// `hint` and `hash_move` were already tried
+				if (move == hint || move == hash_move)
+					continue;
+				// Can't happen in practice, since `MAX_MOVES` is larger than the number of moves in any position
+				if (frame.ordered_move_count == MAX_MOVES)
+					break;
+				
+				int value = 0;
+				value += middlegame_score(Magic::PIECE_SCORES[game.active_player][move_piece(move)][move_to(move)] - Magic::PIECE_SCORES[game.active_player][move_piece(move)][move_from(move)] + Magic::PIECE_SCORES[!game.active_player][move_captured_piece(move)][move_to(move)]);
+				
+				if (is_quiet(move)) {
+					value += (continuation_history[0].get(game.active_player, previous_move, move) + continuation_history[1].get(game.active_player, earlier_move, move)) / HISTORY_ORDERING_DIVISOR;
+					if (move == counter_move)
+						value += COUNTER_MOVE_BONUS;
+					if (move == frame.killers[0] || move == frame.killers[1])
+						value += KILLER_BONUS;
+				}
+				
+				frame.ordered_moves[frame.ordered_move_count++] = { -value, move };
+			}
 		}
-		std::sort(ordered_moves.begin(), ordered_moves.end());
+		std::sort(frame.ordered_moves, frame.ordered_moves + frame.ordered_move_count);
 		
 		normal_move_origin:
 		if (alpha >= beta)
 			goto trials_end;
-		while (move_index < ordered_moves.size()) {
+		while (move_index < frame.ordered_move_count) {
 			
-			if (!searching) {
-				if (depth == 0 && best_move == NULL_MOVE)
-					cout << "Returning null at depth 0 from main search loop" << endl;
+			if (!searching)
 				return { alpha, best_move };
-			}
 			
-			move_to_play = ordered_moves[move_index].second;
+			move_to_play = frame.ordered_moves[move_index].second;
 			goto_origin = 2;
 			move_index++;
 			goto play_move;
@@ -316,8 +564,12 @@ std::pair<int, Move> Hummingbird<V>::search(int depth, int alpha, int beta, Move
 	
 	trials_end:
 	
+	// Remember which quiet move caused the cutoff
+	if (alpha >= beta && best_move && is_quiet(best_move))
+		update_move_history(depth, remaining_depth, best_move);
+	
 	// Update transposition table
-	{
+	if (!is_excluding_moves) {
 		HummingbirdEntry::Precision precision = HummingbirdEntry::NONE;
 		if (best_move) {
 			if (alpha >= initial_alpha && alpha < beta) {
@@ -336,8 +588,8 @@ std::pair<int, Move> Hummingbird<V>::search(int depth, int alpha, int beta, Move
 		if (precision != HummingbirdEntry::NONE) {
 			HummingbirdEntry entry(game.hash);
 			entry.precision = precision;
-			entry.score = alpha;
-			entry.remaining_depth = max_depth - depth;
+			entry.score = score_to_table(alpha, depth);
+			entry.remaining_depth = remaining_depth;
 			entry.best_move = best_move;
 			table.put(entry);
 		}
@@ -346,9 +598,6 @@ std::pair<int, Move> Hummingbird<V>::search(int depth, int alpha, int beta, Move
 	// Fail hard by making sure the return value is in the range `original_alpha ... beta`
 	alpha = std::min(alpha, beta);
 	
-	if (depth == 0 && best_move == NULL_MOVE)
-		cout << "Returning null at depth 0 normally" << endl;
-	
 	return { alpha, best_move };
 	
 	
@@ -356,7 +605,12 @@ std::pair<int, Move> Hummingbird<V>::search(int depth, int alpha, int beta, Move
 	play_move:
 	{
 		bool is_valid_move;
-		if constexpr (Variants::has_forced_capture_enabled(V) || Variants::has_forced_check_enabled(V)) {
+		if (is_excluding_moves && (move_to_play == frame.excluded_move || (depth == 0 && (fruit::contains(excluded_root_moves, move_to_play) || (!tablebase_root_moves.empty() && !fruit::contains(tablebase_root_moves, move_to_play)))))) {
+			// This move is legal, but it isn't part of this search
+			has_legal_moves = true;
+			is_valid_move = false;
+		}
+		else if constexpr (Variants::has_forced_capture_enabled(V) || Variants::has_forced_check_enabled(V)) {
 			// We used `game.legal_moves()` to generate moves above, so `move_to_play` is definitely legal
 			is_valid_move = true;
 			game.apply(move_to_play);
@@ -365,26 +619,52 @@ std::pair<int, Move> Hummingbird<V>::search(int depth, int alpha, int beta, Move
 			// `move_to_play` is quasilegal, so we have to check whether it is actually legal
 			is_valid_move = game.attempt(move_to_play);
 		}
+		bool gives_check = false;
+		if constexpr (!Variants::has_check_disabled(V)) {
+			if (is_valid_move)
+				gives_check = game.is_check(game.active_player);
+		}
+		if (is_valid_move && is_futile && goto_origin == 2 && is_quiet(move_to_play) && !gives_check) {
+			// This move is legal but futile, so skip it
+			game.undo();
+			has_legal_moves = true;
+			is_valid_move = false;
+		}
 		if (is_valid_move) {
 			
 			has_legal_moves = true;
+			if (depth == 0)
+				report_current_move(move_to_play);
+			
+			// Keep following the previous iteration's principal variation while we are on it
+			const bool is_on_hint_variation = depth + 1 < (int)hint_variation.size() && hint == hint_variation[depth] && move_to_play == hint;
+			const Move child_hint = is_on_hint_variation ? hint_variation[depth + 1] : NULL_MOVE;
+			
+			if (is_quiet(move_to_play) && frame.quiet_move_count < MAX_TRACKED_QUIET_MOVES)
+				frame.quiet_moves[frame.quiet_move_count++] = move_to_play;
+			frame.move = move_to_play;
+			
+			// Extend forcing moves
+			int child_extension = extension;
+			if (can_extend && (has_single_reply || move_to_play == singular_move || gives_check))
+				child_extension++;
 			
 //			(score, _) = _search(game: game, depth: depth + 1, alpha: -beta, beta: -alpha, hint: NULL_MOVE)
 //			score = -score
 			if (!zero_window) {
 				// Search with full window
-				const auto result = search(depth + 1, -beta, -alpha, NULL_MOVE);
+				const auto result = search(depth + 1, -beta, -alpha, child_hint, child_extension);
 				score = -result.first;
 				zero_window = true;
 			}
 			else {
 				// Try searching with zero-width window
-				auto result = search(depth + 1, -(alpha + 1), -alpha, NULL_MOVE);
+				auto result = search(depth + 1, -(alpha + 1), -alpha, child_hint, child_extension);
 				score = -result.first;
 				const Move zero_window_best_move = result.second;
 				if (score > alpha && score < beta) {
 					// The real score is in the range `(alpha + 1) ..< beta`. We need to search again with full-width window to find the real score.
-					result = search(depth + 1, -beta, -alpha, zero_window_best_move);
+					result = search(depth + 1, -beta, -alpha, zero_window_best_move, child_extension);
 					score = -result.first;
 					zero_window = false;
 				}
@@ -393,6 +673,12 @@ std::pair<int, Move> Hummingbird<V>::search(int depth, int alpha, int beta, Move
 			if (score > alpha) {
 				alpha = score;
 				best_move = move_to_play;
+				
+				// The principal variation is this move followed by the child's principal variation
+				const SearchFrame &child_frame = search_stack[depth + 1];
+				frame.principal_variation[depth] = move_to_play;
+				std::copy(child_frame.principal_variation + depth + 1, child_frame.principal_variation + child_frame.principal_variation_length, frame.principal_variation + depth + 1);
+				frame.principal_variation_length = std::max(child_frame.principal_variation_length, depth + 1);
 			}
 		}
 	}
@@ -411,20 +697,170 @@ std::pair<int, Move> Hummingbird<V>::search(int depth, int alpha, int beta, Move
 
 
 template<Variant V>
-void Hummingbird<V>::stop_after(double seconds)
+void Hummingbird<V>::set_principal_variation(int depth, Move move)
 {
-	auto func = [target_searches_finished = searches_finished, this]() {
-		// We only want to stop the search that started right after `stop_after` was called. It is possible that that search ended early and that another search is happening right now, in which case we don't want to stop the other search.
-		if (searches_finished == target_searches_finished)
-			stop_immediately();
-	};
-	background_queue.async_after(seconds - 0.005, func);
+	SearchFrame &frame = search_stack[depth];
+	frame.principal_variation[depth] = move;
+	frame.principal_variation_length = move ? depth + 1 : depth;
 }
+
+template<Variant V>
+void Hummingbird<V>::update_move_history(int depth, int remaining_depth, Move best_move)
+{
+	SearchFrame &frame = search_stack[depth];
+	const Move previous_move = depth >= 1 ? search_stack[depth - 1].move : NULL_MOVE;
+	const Move earlier_move = depth >= 2 ? search_stack[depth - 2].move : NULL_MOVE;
+	
+	if (frame.killers[0] != best_move) {
+		frame.killers[1] = frame.killers[0];
+		frame.killers[0] = best_move;
+	}
+	counter_moves.set(game.active_player, previous_move, best_move);
+	
+	const int bonus = std::min(HISTORY_BONUS * remaining_depth * remaining_depth, MAX_HISTORY_BONUS);
+	for (int index = 0; index < frame.quiet_move_count; index++) {
+		const Move quiet_move = frame.quiet_moves[index];
+		const int quiet_move_bonus = quiet_move == best_move ? bonus : -bonus;
+		continuation_history[0].update(game.active_player, previous_move, quiet_move, quiet_move_bonus);
+		continuation_history[1].update(game.active_player, earlier_move, quiet_move, quiet_move_bonus);
+	}
+}
+
+template<Variant V>
+bool Hummingbird<V>::is_easy_move(Move best_move, int score)
+{
+	// Mate scores are already decisive
+	if (std::abs(score) >= CHECKMATE_SCORE - MAX_PLY)
+		return false;
+	
+	const int saved_max_depth = max_depth;
+	max_depth = std::max(max_depth / 2, 1);
+	excluded_root_moves = { best_move };
+	
+	// Null window search: the result is below `threshold` only if every other move fails low
+	const int threshold = score - EASY_MOVE_MARGIN;
+	const int other_score = search(0, threshold - 1, threshold, NULL_MOVE).first;
+	
+	excluded_root_moves.clear();
+	max_depth = saved_max_depth;
+	
+	return searching && other_score < threshold;
+}
+
 template<Variant V>
 void Hummingbird<V>::stop_immediately()
 {
 	searching = false;
 }
+template<Variant V>
+void Hummingbird<V>::begin_pondering()
+{
+	pondering = true;
+}
+template<Variant V>
+void Hummingbird<V>::ponderhit()
+{
+	pondering = false;
+}
+template<Variant V>
+void Hummingbird<V>::check_time()
+{
+	// Switch to the normal time budget as soon as the opponent plays the expected move
+	if (time_manager.is_pondering && !pondering)
+		time_manager.ponderhit();
+	if (time_manager.is_hard_limit_reached())
+		searching = false;
+}
+template<Variant V>
+void Hummingbird<V>::wait_until_released(const SearchLimits &limits)
+{
+	// Nothing else will be sent while waiting
+	if (info_output)
+		info_output->flush();
+	while (searching && (pondering || limits.infinite))
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+template<Variant V>
+bool Hummingbird<V>::is_searching() const
+{
+	return searching;
+}
+
+
+// MARK: - Reporting
+
+template<Variant V>
+void Hummingbird<V>::report_iteration(int score, const std::vector<Move> &variation, int line_number)
+{
+	if (!info_output)
+		return;
+	
+	const double elapsed = search_stopwatch.check();
+	const uint64_t nodes = node_count - search_start_node_count;
+	const uint64_t nodes_per_second = elapsed > 0 ? (uint64_t)(nodes / elapsed) : 0;
+	
+	std::string line = "info";
+	line += " depth " + std::to_string(max_depth);
+	line += " seldepth " + std::to_string(std::max(selective_depth, max_depth));
+	line += " multipv " + std::to_string(line_number);
+	line += " score " + score_to_string(score);
+	line += " nodes " + std::to_string(nodes);
+	line += " nps " + std::to_string(nodes_per_second);
+	line += " hashfull " + std::to_string(table.permille_full());
+	if (Syzygy::largest_table_size)
+		line += " tbhits " + std::to_string(tablebase_hit_count);
+	line += " time " + std::to_string((uint64_t)(elapsed * 1000));
+	line += " pv";
+	for (Move move : variation)
+		line += " " + Notation::move_to_string(move);
+	
+	// Flushed by `find_best_move` once every line of the iteration has been written
+	info_output->write_line(line);
+}
+
+template<Variant V>
+void Hummingbird<V>::report_current_move(Move move)
+{
+	root_move_number++;
+	if (!info_output)
+		return;
+	
+	// Only report once the search has been running for a while, and not too often
+	const double elapsed = search_stopwatch.check();
+	if (elapsed < CURRMOVE_DELAY || elapsed - last_currmove_report < CURRMOVE_INTERVAL)
+		return;
+	last_currmove_report = elapsed;
+	
+	// Progress is only useful while it is current, and the throttling above already limits how often this flushes
+	info_output->write_line("info depth " + std::to_string(max_depth) + " currmove " + Notation::move_to_string(move) + " currmovenumber " + std::to_string(root_move_number));
+	info_output->flush();
+}
+
+template<Variant V>
+void Hummingbird<V>::report_warning(const std::string &warning)
+{
+	// Sent along with the next batch of output
+	if (info_output)
+		info_output->write_line("info string " + warning);
+	else
+		cout << warning << endl;
+}
+
+template<Variant V>
+std::string Hummingbird<V>::score_to_string(int score) const
+{
+	// Mate scores count plies, but UCI counts moves
+	if (score >= CHECKMATE_SCORE - MAX_PLY)
+		return "mate " + std::to_string((CHECKMATE_SCORE - score + 1) / 2);
+	if (score <= -CHECKMATE_SCORE + MAX_PLY)
+		return "mate " + std::to_string(-(CHECKMATE_SCORE + score) / 2);
+	// Tablebase wins don't have a known distance to mate
+	if (score >= TABLEBASE_WIN_SCORE - MAX_PLY)
+		return "cp " + std::to_string(REPORTED_TABLEBASE_WIN_SCORE);
+	if (score <= -TABLEBASE_WIN_SCORE + MAX_PLY)
+		return "cp " + std::to_string(-REPORTED_TABLEBASE_WIN_SCORE);
+	return "cp " + std::to_string(score);
+}
 
 
 // MARK: - Configuration
@@ -440,18 +876,30 @@ void Hummingbird<V>::load_default_opening_book()
 	load_opening_book(OpeningBooks::default_book_name_for_variant(V));
 }
 
+template<Variant V>
+void Hummingbird<V>::reset_tables()
+{
+	table.reset();
+	table_is_empty = true;
+	pawn_table.reset();
+	evaluation_table.reset();
+	for (ContinuationHistory &history : continuation_history)
+		history.reset();
+	counter_moves.reset();
+}
+
 template<Variant V>
 void Hummingbird<V>::setup(const AbstractGame &new_abstract_game)
 {
 	// Try to cast `new_abstract_game` to a `Game<V>`
 	const Game<V> *new_game_ptr = dynamic_cast<const Game<V> *>(&new_abstract_game);
-//	if (new_game_ptr == nullptr) {
-//		std::string variant_name = Notation::variant_to_string(V);
-//		cout << "(Warning) tried to set up Hummingbird<" << variant_name << ">" << " with a game that is not a Game<" << variant_name << ">" << endl;
-//		return;
-//	}
-//	const Game<V> &new_game = *new_game_ptr;
-//
+	if (new_game_ptr == nullptr) {
+		std::string variant_name = Notation::variant_to_string(V);
+		cout << "(Warning) tried to set up Hummingbird<" << variant_name << ">" << " with a game that is not a Game<" << variant_name << ">" << endl;
+		return;
+	}
+	const Game<V> &new_game = *new_game_ptr;
+	
 //	// Decide whether to clear the transposition table
 //	if (!table_is_empty) {
 //		bool should_reset = false;
@@ -469,8 +917,8 @@ void Hummingbird<V>::setup(const AbstractGame &new_abstract_game)
 //			table_is_empty = true;
 //		}
 //	}
-//
-//	game = new_game;
+	
+	game = new_game;
 }
 
 template<Variant V>
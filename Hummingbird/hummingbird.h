@@ -14,6 +14,10 @@
 #include "definitions.h"
 #include "table.h"
 #include "opening_book.h"
+#include "time_manager.h"
+#include "move_history.h"
+#include "syzygy.h"
+#include <atomic>
 
 class AbstractHummingbird
 {
@@ -37,6 +41,7 @@ public:
 	
 	virtual Move find_best_move(int depth) = 0;
 	virtual Move find_best_move(int depth, double seconds) = 0;
+	virtual Move find_best_move(const SearchLimits &limits) = 0;
 };
 
 template<Variant V>
@@ -48,6 +53,8 @@ public:
 	
 	uint64_t node_count = 0;
 	uint64_t leaf_node_count = 0;
+	/// The number of positions that were found in the endgame tablebases during the current search.
+	uint64_t tablebase_hit_count = 0;
 	
 	static constexpr int depth_limit = 9;
 	static constexpr bool uses_opening_book = true;
@@ -55,15 +62,139 @@ public:
 	
 	Table<HummingbirdEntry> table{10'000'000};
 	bool table_is_empty = true;
+	/// Pawn structure terms, keyed by `Game::pawn_hash`. Filled in by `evaluate_pawns()`.
+	mutable Table<PawnEntry> pawn_table{16'384};
+	/// Static evaluations, keyed by `Game::hash`. Filled in by `cached_evaluate()`.
+	mutable Table<EvaluationEntry> evaluation_table{262'144};
 	
 	static constexpr int CHECKMATE_SCORE = 1'000'000;
+	/// The deepest ply that a search can reach. Scores within `MAX_PLY` of `CHECKMATE_SCORE` are mate scores.
+	static constexpr int MAX_PLY = 128;
+	/// The score of a position that the endgame tablebases say is won. Below every mate score, so that a mate that the search finds is still preferred.
+	static constexpr int TABLEBASE_WIN_SCORE = CHECKMATE_SCORE - 2 * MAX_PLY;
+	/// How a tablebase win is reported over UCI. Far above any evaluation, but not so close to a mate score that GUIs mistake it for one.
+	static constexpr int REPORTED_TABLEBASE_WIN_SCORE = 20'000;
+	/// More moves than any position has, even in variants where pieces can capture their own pieces.
+	static constexpr int MAX_MOVES = 512;
+	static constexpr int NO_EVALUATION = INT_MIN;
+	/// A bound on how much the terms after material and pawn structure can change an evaluation, for `evaluate`'s lazy exit.
+	static constexpr int LAZY_EVALUATION_MARGIN = 500;
+	
+	/// When set, `info` lines are written here during the search. Not owned by the hummingbird.
+	fruit::BufferedWriter *info_output = nullptr;
+	/// Seconds to wait after the search starts before reporting `currmove`.
+	static constexpr double CURRMOVE_DELAY = 1;
+	/// Minimum number of seconds between `currmove` reports.
+	static constexpr double CURRMOVE_INTERVAL = 0.25;
+	
+	TimeManager time_manager;
+	/// The reply we expect to the move returned by the last search, or `NULL_MOVE` if there is none.
+	Move ponder_move = NULL_MOVE;
+	/// A root move counts as an easy move if every other move scores at least this much lower.
+	static constexpr int EASY_MOVE_MARGIN = 150;
+	/// The number of best root moves that each iteration finds and reports, each with its own principal variation.
+	int multi_pv = 1;
+	static constexpr int MAX_MULTI_PV = 256;
+	/// Iterations from this depth on search the root with a window of `ASPIRATION_WINDOW` on both sides of the previous iteration's score. The window doubles every time the score falls outside of it.
+	static constexpr int ASPIRATION_MIN_DEPTH = 4;
+	static constexpr int ASPIRATION_WINDOW = 25;
+	/// Once the window grows past this size, the failing side of the window is opened completely.
+	static constexpr int ASPIRATION_MAX_WINDOW = 800;
+	
+	// Pruning near the horizon, in centipawns per remaining ply. These can be changed between searches to tune the search.
+	/// Nodes with at most this many plies left are considered for pruning.
+	int futility_depth = 2;
+	/// A node is cut off when its static evaluation exceeds beta by this margin.
+	int reverse_futility_margin = 200;
+	/// Quiet moves are skipped when the static evaluation plus this margin doesn't reach alpha.
+	int futility_margin = 150;
+	int razoring_depth = 1;
+	/// A node is cut off when its static evaluation plus this margin doesn't reach alpha.
+	int razoring_margin = 400;
+	
+	/// Singular extensions are only tried at nodes with at least this many plies left.
+	static constexpr int SINGULAR_MIN_DEPTH = 4;
+	/// The hash move is singular if every other move scores this much per remaining ply below it.
+	static constexpr int SINGULAR_MARGIN = 25;
+	
+	/// A cutoff adds this much per squared remaining ply to the history of the move that caused it, up to `MAX_HISTORY_BONUS`.
+	static constexpr int HISTORY_BONUS = 32;
+	static constexpr int MAX_HISTORY_BONUS = 1200;
+	/// History scores are divided by this before being added to the ordering score of a quiet move.
+	static constexpr int HISTORY_ORDERING_DIVISOR = 64;
+	static constexpr int COUNTER_MOVE_BONUS = 200;
+	static constexpr int KILLER_BONUS = 100;
+	/// Usage: `Move quiet_moves[MAX_TRACKED_QUIET_MOVES]`. The number of quiet moves per node whose history is updated after a cutoff.
+	static constexpr int MAX_TRACKED_QUIET_MOVES = 64;
+	
+	/// Nodes without a hash move that have at least this many plies left are searched one ply shallower.
+	static constexpr int INTERNAL_ITERATIVE_MIN_DEPTH = 4;
+	/// When set, nodes without a hash move that are searched with a full window first run a search that is this many plies shallower to find one, instead of being reduced.
+	bool uses_internal_iterative_deepening = false;
+	static constexpr int INTERNAL_ITERATIVE_DEEPENING_REDUCTION = 2;
 	
 protected:
 	
-	bool searching = false;
+	/// Set to `true` when a search begins. Any thread may set this to `false` to make the search return as soon as possible.
+	std::atomic<bool> searching = false;
+	/// Whether the current search is pondering on the opponent's time. Cleared by `ponderhit()`.
+	std::atomic<bool> pondering = false;
 	int max_depth = 0;
-	int searches_finished = 0;
-	fruit::DispatchQueue background_queue{"com.mckinleykeys.chaos-chess.hummingbird.hummingbird-background-queue"};
+	/// The search stops once `node_count` reaches this value.
+	uint64_t node_limit = UINT64_MAX;
+	/// Root moves that `search` skips. Used to find the next best line for MultiPV, and to compare the best move against the rest of the root moves.
+	std::vector<Move> excluded_root_moves;
+	/// When not empty, the only root moves that `search` tries. Set by `find_best_move` to the moves that keep the endgame tablebase value of the root, best first.
+	std::vector<Move> tablebase_root_moves;
+	
+	/// One line of an iteration: a root move's score and the principal variation that starts with it.
+	struct RootLine
+	{
+		int score;
+		std::vector<Move> principal_variation;
+	};
+	/// The principal variation of the previous iteration. `search` tries its moves first for as long as it stays on it.
+	std::vector<Move> hint_variation;
+	
+	/// Information about one ply of the path that `search` is currently on. The frames are allocated once, so that `search` doesn't allocate memory.
+	struct SearchFrame
+	{
+		/// The move being searched from this ply.
+		Move move = NULL_MOVE;
+		/// A move that `search` skips at this ply, or `NULL_MOVE`. Used to check whether the hash move is singular.
+		Move excluded_move = NULL_MOVE;
+		/// Quiet moves that recently caused a cutoff at this ply, most recent first.
+		Move killers[2] = {NULL_MOVE, NULL_MOVE};
+		/// `NO_EVALUATION` if the node at this ply didn't need a static evaluation.
+		int static_evaluation = NO_EVALUATION;
+		
+		/// The moves to search after the hint and hash moves. Each score is negated, so that sorting in ascending order puts the best move first.
+		std::pair<int, Move> ordered_moves[MAX_MOVES];
+		int ordered_move_count = 0;
+		/// Legal moves, in variants with forced moves and for the single reply extension. Its capacity is reused between nodes.
+		std::vector<Move> legal_moves;
+		/// The quiet moves searched at this ply, whose history is updated after a cutoff.
+		Move quiet_moves[MAX_TRACKED_QUIET_MOVES];
+		int quiet_move_count = 0;
+		
+		/// Usage: `principal_variation[depth ..< principal_variation_length]`. The best line found so far from the node at this ply. Moves are stored at the same index as in the root's line, so that a child's line can be copied without shifting it.
+		Move principal_variation[MAX_PLY + 1];
+		int principal_variation_length = 0;
+	};
+	/// Usage: `search_stack[depth]`. Each thread searches with its own hummingbird, so each thread has its own stack.
+	std::vector<SearchFrame> search_stack = std::vector<SearchFrame>(MAX_PLY + 1);
+	
+	// Quiet move ordering. These persist between searches.
+	/// Usage: `continuation_history[plies_back - 1]`. Separate tables for replies to the previous move and to the move before it.
+	ContinuationHistory continuation_history[2];
+	CounterMoveTable counter_moves;
+	
+	// Search statistics used for `info` output
+	fruit::Stopwatch search_stopwatch;
+	uint64_t search_start_node_count = 0;
+	int selective_depth = 0;
+	int root_move_number = 0;
+	double last_currmove_report = 0;
 	
 public:
 	
@@ -74,7 +205,15 @@ public:
 	
 	Move find_best_move(int depth);
 	Move find_best_move(int depth, double seconds);
-	std::pair<int, Move> search(int depth, int alpha, int beta, Move hint);
+	Move find_best_move(const SearchLimits &limits);
+	/// `extension` is the total extension of the path leading to this node, in plies. It moves the horizon of the path beyond `max_depth`, or before it when negative.
+	std::pair<int, Move> search(int depth, int alpha, int beta, Move hint, int extension = 0);
+	/// Returns whether every root move other than `best_move` scores at least `EASY_MOVE_MARGIN` below `score` in a reduced-depth search.
+	bool is_easy_move(Move best_move, int score);
+	/// Makes `move` the whole principal variation at `depth`, or clears it if `move` is `NULL_MOVE`.
+	void set_principal_variation(int depth, Move move);
+	/// Rewards the quiet move `best_move` for causing a cutoff at `depth`, and punishes the other quiet moves that were searched before it.
+	void update_move_history(int depth, int remaining_depth, Move best_move);
 	
 	inline void sort_moves(const std::vector<Move> &moves, std::vector<std::pair<int, Move>> &ordered_moves) const
 	{
@@ -82,62 +221,99 @@ public:
 		for (Move move : moves) {
 			
 			int value = 0;
-			value += Magic::PIECE_SCORES[false][game.active_player][move_piece(move)][move_to(move)];
-			value -= Magic::PIECE_SCORES[false][game.active_player][move_piece(move)][move_from(move)];
-			value += Magic::PIECE_SCORES[false][!game.active_player][move_captured_piece(move)][move_to(move)];
+			value += middlegame_score(Magic::PIECE_SCORES[game.active_player][move_piece(move)][move_to(move)] - Magic::PIECE_SCORES[game.active_player][move_piece(move)][move_from(move)] + Magic::PIECE_SCORES[!game.active_player][move_captured_piece(move)][move_to(move)]);
 			
 			ordered_moves.emplace_back(-value, move);
 		}
 		std::sort(ordered_moves.begin(), ordered_moves.end());
 	}
 	
-	void stop_after(double seconds);
+	/// Thread-safe. Makes the current search return as soon as possible.
 	void stop_immediately();
+	/// Must be called before `find_best_move` for searches with `SearchLimits::ponder` set, so that a `ponderhit()` can't arrive before the search starts pondering.
+	void begin_pondering();
+	/// Thread-safe. Tells a pondering search that the opponent played the expected move.
+	void ponderhit();
+	/// Checks the clock and whether a `ponderhit()` arrived. Called by the search thread every so often.
+	void check_time();
+	/// UCI forbids sending `bestmove` during a `go infinite` search before `stop`, or during a pondering search before `ponderhit` or `stop`. Waits until the search may return.
+	void wait_until_released(const SearchLimits &limits);
+	bool is_searching() const;
+	
+	
+	// MARK: - Reporting
+	
+	/// Sends an `info` line summarizing one line of the iteration that just finished. `line_number` is the rank of the line, starting at 1.
+	void report_iteration(int score, const std::vector<Move> &variation, int line_number);
+	/// Sends a throttled `currmove` line when the root starts searching `move`.
+	void report_current_move(Move move);
+	void report_warning(const std::string &warning);
+	std::string score_to_string(int score) const;
 	
 	
 	// MARK: - Evaluation
 	
+	/// Returns `evaluate(depth)`, reusing the full evaluation from `evaluation_table` if this position has been evaluated before.
+	/// Lazy evaluation: when material and pawn structure alone put the position more than `LAZY_EVALUATION_MARGIN` outside of `alpha ... beta`, the remaining terms can't bring it back into the window, so they are skipped. The lazy exit is taken before the table is consulted, so that a leaf gets the same score whether or not its full evaluation happens to be stored, and node counts don't depend on the table's contents.
+	inline int cached_evaluate(int depth, int alpha = -CHECKMATE_SCORE, int beta = CHECKMATE_SCORE) const
+	{
+		const PawnEntry *pawns = nullptr;
+		int material = 0;
+		if constexpr (Variants::has_material_as_main_objective(V)) {
+			if (!NNUE::networks[V]) {
+				pawns = &evaluate_pawns();
+				material = material_evaluation(*pawns);
+				if (is_outside_lazy_window(material, alpha, beta))
+					return material;
+			}
+		}
+		if (EvaluationEntry *entry = evaluation_table.get(game.hash))
+			return entry->evaluation;
+		const int evaluation = pawns ? evaluate(*pawns, material) : evaluate(depth);
+		evaluation_table.put(EvaluationEntry(game.hash, evaluation));
+		return evaluation;
+	}
+	
 	inline int evaluate(int depth) const
 	{
-		int material_middlegame[] = {0, 0};
-		int material_endgame[] = {0, 0};
-		int endgame_progress = 0;
+		if (const NNUE::Network *network = NNUE::networks[V].get())
+			return network->evaluate(game.accumulator(*network), game.active_player);
+		
+		const PawnEntry &pawns = evaluate_pawns();
+		return evaluate(pawns, material_evaluation(pawns));
+	}
+	
+	/// Returns the full hand-crafted evaluation, starting from `material`, which must be `material_evaluation(pawns)`.
+	inline int evaluate(const PawnEntry &pawns, int material) const
+	{
+		int total = material;
+		
+		const AttackMaps *attack_maps[] = {
+			&game.template attack_maps<WHITE>(),
+			&game.template attack_maps<BLACK>(),
+		};
 		
-		int total = 0;
 		for (int player = WHITE; player <= BLACK; player++) {
 			
 			int score = 0;
 			
-			// Material
-			Bitboard FRIENDLY = game.PLAYERS[player];
-			while (FRIENDLY) {
-				int square = pop_lsb(FRIENDLY);
-				Piece piece = game.list[square];
-				material_middlegame[player] += Magic::PIECE_SCORES[false][player][piece][square];
-				material_endgame[player] += Magic::PIECE_SCORES[true][player][piece][square];
-				endgame_progress += Magic::ENDGAME_PROGRESS[piece];
+			// Knight outposts
+			if constexpr (V != LOSER) {
+				const Bitboard OUTPOSTS = Magic::OUTPOST_RANKS[player] & attack_maps[player]->BY_PIECE[PAWN] & ~pawns.ATTACK_SPANS[!player];
+				score += Magic::KNIGHT_OUTPOST_SCORE * popcount(game.PIECES[KNIGHT] & game.PLAYERS[player] & OUTPOSTS);
 			}
 			
 			// Bishops
 			if (popcount(game.PIECES[BISHOP] & game.PLAYERS[player]) >= 2)
-				score += 30;
+				score += Magic::BISHOP_PAIR_SCORE;
 			
-			// Moveability
-			if (player == WHITE)
-				game.template generate_quasilegal_moves_for<WHITE>();
-			if (player == BLACK)
-				game.template generate_quasilegal_moves_for<BLACK>();
-			size_t move_count = game.quasilegal_moves.size();
-			score += 4 * (int)move_count;
+			// Mobility
+			score += Magic::MOBILITY_SCORE * attack_maps[player]->mobility;
 			
 			// Attacks
-			Bitboard ATTACKED_FRIENDLY = game.PLAYERS[player] & ((player == WHITE) ? game.template attacked_squares<BLACK>() : game.template attacked_squares<WHITE>());
-			score -= 8 * popcount(game.PIECES[PAWN] & ATTACKED_FRIENDLY);
-			score -= 40 * popcount(game.PIECES[KNIGHT] & ATTACKED_FRIENDLY);
-			score -= 40 * popcount(game.PIECES[BISHOP] & ATTACKED_FRIENDLY);
-			score -= 80 * popcount(game.PIECES[ROOK] & ATTACKED_FRIENDLY);
-			score -= 120 * popcount(game.PIECES[QUEEN] & ATTACKED_FRIENDLY);
-			score -= 220 * popcount(game.PIECES[KING] & ATTACKED_FRIENDLY);
+			Bitboard ATTACKED_FRIENDLY = game.PLAYERS[player] & attack_maps[!player]->ALL;
+			for (Piece piece = PAWN; piece <= KING; piece++)
+				score += Magic::ATTACKED_PIECE_SCORES[piece] * popcount(game.PIECES[piece] & ATTACKED_FRIENDLY);
 			
 			// Castling rights
 			if constexpr (V == KING_OF_THE_HILL_AND_COMPULSION) {
@@ -145,35 +321,98 @@ public:
 			}
 			else {
 				if (game.can_castle_kingside(player))
-					score += 20;
+					score += Magic::CASTLING_RIGHT_SCORE;
 				if (game.can_castle_queenside(player))
-					score += 20;
+					score += Magic::CASTLING_RIGHT_SCORE;
 			}
 			
 			// Variant-specific factors
 			if constexpr (V == KING_OF_THE_HILL_AND_COMPULSION) {
 				Bitboard K = game.PIECES[KING] & game.PLAYERS[player];
 				if (K & Magic::RING_OF_RADIUS_2)
-					score += 400;
+					score += Magic::KING_NEAR_HILL_SCORE;
 				else if (K & Magic::RING_OF_RADIUS_3)
-					score += 200;
+					score += Magic::KING_APPROACHING_HILL_SCORE;
 			}
-
+			
 			if (player == game.active_player) total += score;
 			else total -= score;
 		}
 		
-		// Material
-		endgame_progress = std::min(endgame_progress, 24);
-		const int total_material = ((material_middlegame[game.active_player] - material_middlegame[!game.active_player]) * endgame_progress + (material_endgame[game.active_player] - material_endgame[!game.active_player]) * (24 - endgame_progress)) / 24;
-		if constexpr (V == LOSER) {
-			total -= total_material;
-		}
-		else {
-			total += total_material;
+		return total;
+	}
+	
+	/// Returns the material (kept up to date by `Game::apply` and `Game::undo`) and pawn structure terms of the evaluation, from the active player's point of view.
+	inline int material_evaluation(const PawnEntry &pawns) const
+	{
+		const PieceScores &piece_scores = game.piece_scores;
+		Score material = piece_scores.material[game.active_player] - piece_scores.material[!game.active_player];
+		if constexpr (V != LOSER)
+			material += pawns.score[game.active_player] - pawns.score[!game.active_player];
+		const int endgame_progress = std::min(piece_scores.endgame_progress[WHITE] + piece_scores.endgame_progress[BLACK], 24);
+		const int total_material = (middlegame_score(material) * endgame_progress + endgame_score(material) * (24 - endgame_progress)) / 24;
+		return (V == LOSER) ? -total_material : total_material;
+	}
+	
+	/// Whether `material_evaluation()` is far enough outside of `alpha ... beta` that the remaining terms can't bring it back. The other terms are bounded only in variants where they aren't outweighed by variant-specific scores.
+	inline bool is_outside_lazy_window(int evaluation, int alpha, int beta) const
+	{
+		if constexpr (Variants::has_material_as_main_objective(V))
+			return evaluation - LAZY_EVALUATION_MARGIN >= beta || evaluation + LAZY_EVALUATION_MARGIN <= alpha;
+		return false;
+	}
+	
+	/// Returns the pawn structure terms of the current position, computing them only if `pawn_table` does not already hold them.
+	inline const PawnEntry &evaluate_pawns() const
+	{
+		PawnEntry *entry = pawn_table.get_pointer(game.pawn_hash);
+		if (entry->does_exist() && entry->key == game.pawn_hash)
+			return *entry;
+		
+		*entry = PawnEntry(game.pawn_hash);
+		entry->exists = true;
+		
+		const Bitboard PAWNS[] = {
+			game.PIECES[PAWN] & game.PLAYERS[WHITE],
+			game.PIECES[PAWN] & game.PLAYERS[BLACK],
+		};
+		const Bitboard PAWN_ATTACKS[] = {
+			shift<NORTH_EAST>(PAWNS[WHITE]) | shift<NORTH_WEST>(PAWNS[WHITE]),
+			shift<SOUTH_EAST>(PAWNS[BLACK]) | shift<SOUTH_WEST>(PAWNS[BLACK]),
+		};
+		
+		for (int player = WHITE; player <= BLACK; player++) {
+			const Bitboard FRIENDLY = PAWNS[player];
+			const Bitboard ENEMY = PAWNS[!player];
+			
+			const Bitboard FRONT_SPAN = (player == WHITE) ? fill<NORTH>(shift<NORTH>(FRIENDLY)) : fill<SOUTH>(shift<SOUTH>(FRIENDLY));
+			entry->ATTACK_SPANS[player] = shift<EAST>(FRONT_SPAN) | shift<WEST>(FRONT_SPAN);
+			
+			for (Bitboard P = FRIENDLY; P; ) {
+				const int square = pop_lsb(P);
+				const Bitboard S = square_to_bitboard(square);
+				const Bitboard FRONT = (player == WHITE) ? fill<NORTH>(shift<NORTH>(S)) : fill<SOUTH>(shift<SOUTH>(S));
+				const Bitboard ADJACENT_FILES = shift<EAST>(FILES[square]) | shift<WEST>(FILES[square]);
+				const int rank = (player == WHITE) ? square / 8 : 7 - square / 8;
+				
+				const bool is_passed = (ENEMY & (FRONT | shift<EAST>(FRONT) | shift<WEST>(FRONT))) == 0;
+				const bool is_doubled = FRIENDLY & FRONT;
+				const bool is_isolated = (FRIENDLY & ADJACENT_FILES) == 0;
+				const bool is_defended = PAWN_ATTACKS[player] & S;
+				
+				Score &score = entry->score[player];
+				if (is_passed)
+					score += make_score(Magic::PASSED_PAWN_SCORES[false][rank], Magic::PASSED_PAWN_SCORES[true][rank]);
+				if (is_doubled)
+					score += make_score(Magic::DOUBLED_PAWN_SCORE[false], Magic::DOUBLED_PAWN_SCORE[true]);
+				if (is_isolated)
+					score += make_score(Magic::ISOLATED_PAWN_SCORE[false], Magic::ISOLATED_PAWN_SCORE[true]);
+				if (is_defended)
+					score += make_score(Magic::DEFENDED_PAWN_SCORE[false], Magic::DEFENDED_PAWN_SCORE[true]);
+			}
 		}
 		
-		return total;
+		return *entry;
 	}
 	
 	inline int checkmate_score(int depth) const
@@ -181,12 +420,49 @@ public:
 		return CHECKMATE_SCORE - depth;
 	}
 	
+	/// Returns the ply at which a path with a total extension of `extension` reaches its horizon.
+	inline int horizon_for(int extension) const
+	{
+		return std::min(max_depth + extension, MAX_PLY - 1);
+	}
+	
+	/// Converts a tablebase value to a score. Cursed wins and blessed losses are draws under the fifty move rule.
+	inline int tablebase_score(Syzygy::WDL wdl) const
+	{
+		if (wdl == Syzygy::WIN || (wdl == Syzygy::CURSED_WIN && !game.fifty_move_rule_enabled))
+			return TABLEBASE_WIN_SCORE;
+		if (wdl == Syzygy::LOSS || (wdl == Syzygy::BLESSED_LOSS && !game.fifty_move_rule_enabled))
+			return -TABLEBASE_WIN_SCORE;
+		return 0;
+	}
+	
+	/// Mate scores count plies from the root during the search, but from the position itself in the transposition table, so that an entry stays correct when the position is reached at a different depth.
+	inline int score_to_table(int score, int depth) const
+	{
+		if (score >= CHECKMATE_SCORE - MAX_PLY && score <= CHECKMATE_SCORE)
+			return score + depth;
+		if (score <= -(CHECKMATE_SCORE - MAX_PLY) && score >= -CHECKMATE_SCORE)
+			return score - depth;
+		return score;
+	}
+	/// Undoes `score_to_table` for an entry that is read at `depth`.
+	inline int score_from_table(int score, int depth) const
+	{
+		if (score >= CHECKMATE_SCORE - MAX_PLY && score <= CHECKMATE_SCORE)
+			return score - depth;
+		if (score <= -(CHECKMATE_SCORE - MAX_PLY) && score >= -CHECKMATE_SCORE)
+			return score + depth;
+		return score;
+	}
+	
 	
 	// MARK: - Configuration
 	
 	void load_opening_book(const std::string &book_name);
 	/// Loads the default opening book for this variant, if one exists.
 	void load_default_opening_book();
+	/// Clears the transposition table and the move ordering history, as if no search had been run yet.
+	void reset_tables();
 	
 	void setup(const AbstractGame &new_game);
 	void apply(Move move);
@@ -0,0 +1,85 @@
+//
+//  move_history.h
+//  Chaos Chess (Hummingbird)
+//
+//  Created by McKinley Keys on 10/19/26.
+//
+
+#pragma once
+#ifndef move_history_h
+#define move_history_h
+
+#include "fruit.h"
+#include "definitions.h"
+
+/// Scores quiet moves by how well they worked in reply to an earlier move. A move is identified by its piece and destination square, so that the same reply is recognized in different positions. Each table should only hold earlier moves from the same number of plies back, so that together with the player making the reply, the colors of both pieces are known.
+class ContinuationHistory
+{
+private:
+	/// Usage: `scores[(player * MOVE_INDEX_COUNT + index(earlier_move)) * MOVE_INDEX_COUNT + index(move)]`, where `player` makes `move`.
+	std::vector<int16_t> scores;
+	
+	static constexpr int MOVE_INDEX_COUNT = PIECE_COUNT * 64;
+	
+	static inline int index(Move move)
+	{
+		return move_piece(move) * 64 + move_to(move);
+	}
+	
+public:
+	/// Scores stay within `-MAX_SCORE ... MAX_SCORE`.
+	static constexpr int MAX_SCORE = 16384;
+	
+	ContinuationHistory() : scores(2 * MOVE_INDEX_COUNT * MOVE_INDEX_COUNT)
+	{}
+	
+	/// Returns the score of `player` making `move` in reply to `earlier_move`, or `0` if there is no earlier move.
+	inline int get(Color player, Move earlier_move, Move move) const
+	{
+		if (!earlier_move)
+			return 0;
+		return scores[(player * MOVE_INDEX_COUNT + index(earlier_move)) * MOVE_INDEX_COUNT + index(move)];
+	}
+	/// Adds `bonus` to the score of `player` making `move` in reply to `earlier_move`. The closer the score already is to the limit in the direction of `bonus`, the less it changes.
+	inline void update(Color player, Move earlier_move, Move move, int bonus)
+	{
+		if (!earlier_move)
+			return;
+		int16_t &score = scores[(player * MOVE_INDEX_COUNT + index(earlier_move)) * MOVE_INDEX_COUNT + index(move)];
+		score += bonus - score * std::abs(bonus) / MAX_SCORE;
+	}
+	
+	inline void reset()
+	{
+		std::fill(scores.begin(), scores.end(), 0);
+	}
+};
+
+/// Remembers, for each move, the quiet reply that most recently caused a cutoff.
+class CounterMoveTable
+{
+private:
+	/// Usage: `moves[player][piece][square]`, where `player` made the reply and the earlier move put `piece` on `square`.
+	Move moves[2][PIECE_COUNT][64] = {};
+	
+public:
+	/// Returns the counter move that `player` has for `earlier_move`, or `NULL_MOVE` if there is none.
+	inline Move get(Color player, Move earlier_move) const
+	{
+		if (!earlier_move)
+			return NULL_MOVE;
+		return moves[player][move_piece(earlier_move)][move_to(earlier_move)];
+	}
+	inline void set(Color player, Move earlier_move, Move move)
+	{
+		if (earlier_move)
+			moves[player][move_piece(earlier_move)][move_to(earlier_move)] = move;
+	}
+	
+	inline void reset()
+	{
+		std::fill(&moves[0][0][0], &moves[0][0][0] + 2 * PIECE_COUNT * 64, NULL_MOVE);
+	}
+};
+
+#endif /* move_history_h */
@@ -44,6 +44,17 @@ public:
 	{
 		std::fill(entries.begin(), entries.end(), E());
 	}
+	
+	/// Estimates how full the table is, in permille, by sampling the first thousand entries.
+	inline int permille_full()
+	{
+		const int sample_size = std::min(size, 1000);
+		int used = 0;
+		for (int index = 0; index < sample_size; index++)
+			if (entries[index].does_exist())
+				used++;
+		return used * 1000 / std::max(sample_size, 1);
+	}
 };
 
 
@@ -83,6 +94,39 @@ struct HummingbirdEntry
 	}
 };
 
+/// The pawn structure terms of one position, shared by every position with the same pawns.
+struct PawnEntry
+{
+	HashKey key;
+	bool exists;
+	/// Usage: `score[player]`. The pawn structure score of `player`.
+	Score score[2];
+	/// Usage: `ATTACK_SPANS[player]`. Every square that `player`'s pawns attack now or could attack by advancing.
+	Bitboard ATTACK_SPANS[2];
+	
+	PawnEntry(HashKey _key) : key(_key), exists(false), score{}, ATTACK_SPANS{} {}
+	PawnEntry() : PawnEntry(0) {}
+	
+	inline bool does_exist()
+	{
+		return exists;
+	}
+};
+/// The static evaluation of one position.
+struct EvaluationEntry
+{
+	HashKey key;
+	bool exists;
+	int evaluation;
+	
+	EvaluationEntry(HashKey _key, int _evaluation) : key(_key), exists(true), evaluation(_evaluation) {}
+	EvaluationEntry() : key(0), exists(false), evaluation(0) {}
+	
+	inline bool does_exist()
+	{
+		return exists;
+	}
+};
 
 namespace Zobrist
 {
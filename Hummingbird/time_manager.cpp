@@ -0,0 +1,144 @@
+//
+//  time_manager.cpp
+//  Chaos Chess (Hummingbird)
+//
+//  Created by McKinley Keys on 10/18/26.
+//
+
+#include "time_manager.h"
+
+bool SearchLimits::has_clock(Color player) const
+{
+	return move_time == 0 && !infinite && has_time[player];
+}
+
+bool SearchLimits::is_deterministic() const
+{
+	return nodes > 0 && move_time == 0 && !has_time[WHITE] && !has_time[BLACK];
+}
+
+
+// MARK: - Time Manager
+
+void TimeManager::start(const SearchLimits &limits, Color player)
+{
+	soft_limit = 0;
+	hard_limit = 0;
+	uses_clock = false;
+	is_pondering = limits.ponder;
+	
+	if (limits.move_time > 0) {
+		// Use all of the time we were given
+		soft_limit = hard_limit = std::max(limits.move_time - move_overhead, 0.001);
+	}
+	else if (limits.has_clock(player)) {
+		// A clock that has run out still gets a minimal budget rather than none at all
+		const double available = std::max({limits.time[player] - move_overhead, move_overhead, 0.001});
+		const int moves_left = limits.moves_to_go > 0 ? std::min(limits.moves_to_go, 50) : DEFAULT_MOVES_TO_GO;
+		// When this is the last move before the time control, the clock will be replenished, so we can afford to use most of it
+		const double max_soft_fraction = moves_left == 1 ? MAX_HARD_FRACTION : MAX_SOFT_FRACTION;
+		
+		soft_limit = std::min(available / moves_left + 0.75 * limits.increment[player], available * max_soft_fraction);
+		hard_limit = std::min(soft_limit * HARD_LIMIT_FACTOR, available * MAX_HARD_FRACTION);
+		hard_limit = std::max(hard_limit, soft_limit);
+		uses_clock = true;
+	}
+	
+	restart();
+}
+
+void TimeManager::restart()
+{
+	stopwatch.start();
+	last_iteration_end = 0;
+	iteration_durations[0] = iteration_durations[1] = 0;
+	iteration_count = 0;
+	previous_best_move = NULL_MOVE;
+	previous_score = 0;
+	best_move_changes = 0;
+	soft_limit_scale = 1;
+	has_failed_low = false;
+	last_iteration_failed_low = false;
+}
+
+void TimeManager::ponderhit()
+{
+	// Carry over the part of the current iteration that was done while pondering
+	const double current_iteration_progress = elapsed() - last_iteration_end;
+	stopwatch.start();
+	last_iteration_end = -current_iteration_progress;
+	is_pondering = false;
+}
+
+double TimeManager::elapsed() const
+{
+	return stopwatch.check();
+}
+
+bool TimeManager::is_hard_limit_reached() const
+{
+	return !is_pondering && hard_limit > 0 && elapsed() >= hard_limit;
+}
+
+void TimeManager::root_failed_low()
+{
+	has_failed_low = true;
+}
+
+void TimeManager::iteration_finished(Move best_move, int score)
+{
+	const double now = elapsed();
+	iteration_durations[1] = iteration_durations[0];
+	iteration_durations[0] = now - last_iteration_end;
+	last_iteration_end = now;
+	
+	iteration_count++;
+	if (iteration_count > 1) {
+		
+		// Older changes of mind matter less than recent ones
+		best_move_changes /= 2;
+		if (best_move != previous_best_move)
+			best_move_changes += 1;
+		
+		// Between 0.75 (the best move never changes) and 2.25 (it changes every iteration)
+		const double stability_factor = 0.75 + 0.75 * best_move_changes;
+		// Spend more time when the score is falling, and slightly less when it is rising
+		const double score_drop = previous_score - score;
+		const double falling_factor = std::clamp(1 + score_drop / SCORE_DROP_DOUBLING, 0.8, 2.0);
+		
+		// The score only settled after the root failed low, so the best move is probably not reliable yet
+		const double fail_low_factor = has_failed_low ? FAIL_LOW_FACTOR : 1;
+		
+		soft_limit_scale = std::clamp(stability_factor * falling_factor * fail_low_factor, 0.4, 3.0);
+	}
+	previous_best_move = best_move;
+	previous_score = score;
+	last_iteration_failed_low = has_failed_low;
+	has_failed_low = false;
+}
+
+bool TimeManager::should_start_iteration() const
+{
+	if (soft_limit == 0 || is_pondering)
+		return true;
+	
+	// Each iteration takes roughly a constant factor longer than the previous one
+	double branching_factor = DEFAULT_BRANCHING_FACTOR;
+	if (iteration_durations[1] > 0.001)
+		branching_factor = std::clamp(iteration_durations[0] / iteration_durations[1], 1.5, 8.0);
+	const double predicted_duration = iteration_durations[0] * branching_factor;
+	
+	return elapsed() + predicted_duration < scaled_soft_limit();
+}
+
+bool TimeManager::should_check_easy_move() const
+{
+	return uses_clock && !is_pondering && !last_iteration_failed_low && iteration_count >= 5 && best_move_changes < 0.1 && elapsed() > soft_limit * EASY_MOVE_FRACTION;
+}
+
+double TimeManager::scaled_soft_limit() const
+{
+	if (!uses_clock)
+		return soft_limit;
+	return std::min(soft_limit * soft_limit_scale, hard_limit);
+}
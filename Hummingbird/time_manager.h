@@ -0,0 +1,113 @@
+//
+//  time_manager.h
+//  Chaos Chess (Hummingbird)
+//
+//  Created by McKinley Keys on 10/18/26.
+//
+
+#pragma once
+#ifndef time_manager_h
+#define time_manager_h
+
+#include "fruit.h"
+#include "definitions.h"
+
+/// The limits that a `go` command places on a search. A value of `0` means that the limit was not given.
+struct SearchLimits
+{
+	int depth = 0;
+	uint64_t nodes = 0;
+	/// Exact time to spend on this move, in seconds.
+	double move_time = 0;
+	/// Usage: `time[player]`. The remaining time on each player's clock, in seconds. Can be zero or negative once the clock has run out.
+	double time[2] = {0, 0};
+	/// Usage: `has_time[player]`. Whether `time[player]` was given.
+	bool has_time[2] = {false, false};
+	/// Usage: `increment[player]`. The time added to each player's clock after every move, in seconds.
+	double increment[2] = {0, 0};
+	int moves_to_go = 0;
+	bool infinite = false;
+	/// Whether the search starts on the opponent's time. The limits only apply once the opponent plays the expected move.
+	bool ponder = false;
+	
+	/// Returns whether the search has to manage a clock for `player`, as opposed to searching for a fixed time or without a time limit.
+	bool has_clock(Color player) const;
+	/// Returns whether the search is limited only by depth and nodes. Such searches have no clock, so on a single thread they always produce the same result. A node budget given alongside a clock or a move time doesn't make the search deterministic, because the time limits still apply.
+	bool is_deterministic() const;
+};
+
+/// Decides how long a search may take. The soft limit is the time we would like to use; iterations that are unlikely to finish before it are not started. The hard limit is the time after which the search is stopped, even in the middle of an iteration.
+class TimeManager
+{
+public:
+	
+	/// Seconds to keep in reserve on every move to account for the delay between Hummingbird and the GUI.
+	double move_overhead = 0.01;
+	
+	/// Number of moves we assume are left in the game when the GUI doesn't say.
+	static constexpr int DEFAULT_MOVES_TO_GO = 30;
+	/// The largest fraction of the clock that the soft limit may take when more than one move is left.
+	static constexpr double MAX_SOFT_FRACTION = 0.5;
+	/// The largest fraction of the clock that the hard limit may take.
+	static constexpr double MAX_HARD_FRACTION = 0.8;
+	static constexpr double HARD_LIMIT_FACTOR = 4;
+	/// Used to predict the next iteration's duration until two iterations have been timed.
+	static constexpr double DEFAULT_BRANCHING_FACTOR = 3;
+	/// A drop in score of this many centipawns between iterations doubles the soft limit.
+	static constexpr double SCORE_DROP_DOUBLING = 200;
+	/// Once this fraction of the soft limit has passed, a move that is far ahead of the others is played without searching further.
+	static constexpr double EASY_MOVE_FRACTION = 0.25;
+	/// Multiplies the soft limit after an iteration in which the root failed low.
+	static constexpr double FAIL_LOW_FACTOR = 1.5;
+	
+	/// In seconds. `0` means there is no limit.
+	double soft_limit = 0;
+	/// In seconds. `0` means there is no limit.
+	double hard_limit = 0;
+	/// Whether the limits come from the clock, as opposed to a fixed move time. Only limits from the clock are scaled.
+	bool uses_clock = false;
+	/// While pondering, the limits are computed but not enforced.
+	bool is_pondering = false;
+	
+	/// Computes the limits for a search by `player` and starts the clock.
+	void start(const SearchLimits &limits, Color player);
+	/// Restarts the clock without changing the limits.
+	void restart();
+	/// Starts enforcing the limits, measuring time from now. Progress made while pondering still counts towards predicting iteration durations.
+	void ponderhit();
+	/// Returns the number of seconds since the search started.
+	double elapsed() const;
+	
+	/// Returns whether the search must stop immediately.
+	bool is_hard_limit_reached() const;
+	/// Records that the root failed low during the current iteration.
+	void root_failed_low();
+	/// Records the result of an iteration. Used to predict the duration of the next one and to scale the soft limit: changes of best move, drops in score and a root that failed low stretch it, while a stable best move shrinks it.
+	void iteration_finished(Move best_move, int score);
+	/// Returns whether the next iteration is likely to finish before the scaled soft limit.
+	bool should_start_iteration() const;
+	/// Returns whether the best move has been stable long enough, and enough time has passed, that it is worth checking whether it is far ahead of the other moves.
+	bool should_check_easy_move() const;
+	
+	/// The soft limit after scaling for best move stability and score swings.
+	double scaled_soft_limit() const;
+	
+private:
+	
+	fruit::Stopwatch stopwatch;
+	double last_iteration_end = 0;
+	/// Durations of the last two iterations, most recent first.
+	double iteration_durations[2] = {0, 0};
+	
+	int iteration_count = 0;
+	Move previous_best_move = NULL_MOVE;
+	int previous_score = 0;
+	/// Decaying count of how often the best move changed in recent iterations.
+	double best_move_changes = 0;
+	double soft_limit_scale = 1;
+	/// Whether the root failed low during the current iteration, and during the last finished one.
+	bool has_failed_low = false;
+	bool last_iteration_failed_low = false;
+};
+
+#endif /* time_manager_h */
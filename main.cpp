@@ -15,11 +15,15 @@
 #include "hummingbird_tester.h"
 #include "opening_book.h"
 #include "notation.h"
+#include "tuner.h"
 
 void play_game();
 void parse_args(int argc, char **argv);
+int parse_count_arg(const std::string &arg, int minimum, int argc, char **argv, int &i);
 
 constexpr Variant V = CLASSIC;
+/// Set by `--tune`.
+std::optional<Tuner::Settings> tuner_settings;
 
 int main(int argc, char **argv)
 {
@@ -29,6 +33,11 @@ int main(int argc, char **argv)
 	Magic::init();
 	parse_args(argc, argv);
 	
+	if (tuner_settings.has_value()) {
+		Tuner::tune(tuner_settings.value());
+		return 0;
+	}
+	
 //	Hummingbird<V> hummingbird;
 //	hummingbird.load_default_opening_book();
 //	hummingbird.opening_book.sanity_check();
@@ -40,6 +49,7 @@ int main(int argc, char **argv)
 //	HummingbirdTester::speed_test<CLASSIC>();
 //	HummingbirdTester::rigorous_test<V>();
 //	HummingbirdTester::puzzle_test<V>();
+//	HummingbirdTester::node_budget_test<V>();
 //	HummingbirdTester::endgame_test<V>();
 //	HummingbirdTester::calculate_elo(argc, argv);
 //	HummingbirdTester::compare_elo(argc, argv);
@@ -112,13 +122,58 @@ int main(int argc, char **argv)
 void parse_args(int argc, char **argv)
 {
 	// Boost has a good argument parser library: https://www.boost.org/doc/libs/1_49_0/doc/html/program_options/tutorial.html#id2499896
+	// The tuner options may come before `--tune`, so they are only applied once every argument has been read
+	std::optional<int> tune_epochs;
+	std::optional<int> tune_threads;
 	for (int i = 1; i < argc; i++) {
 		const std::string arg(argv[i]);
 		if (arg == "--opening-book-dir") {
 			i++;
 			OpeningBooks::search_path = std::filesystem::path(std::string(argv[i]));
 		}
+		else if (arg == "--tune") {
+			if (i + 2 >= argc)
+				fruit::fatal_error("--tune requires <data> <output>");
+			tuner_settings = Tuner::Settings();
+			tuner_settings->data_url = argv[i + 1];
+			tuner_settings->output_url = argv[i + 2];
+			i += 2;
+		}
+		else if (arg == "--tune-epochs") {
+			// Zero epochs only writes out the starting parameters, which checks that the tuner reproduces them
+			tune_epochs = parse_count_arg(arg, 0, argc, argv, i);
+		}
+		else if (arg == "--tune-threads") {
+			tune_threads = parse_count_arg(arg, 1, argc, argv, i);
+		}
+	}
+	
+	if ((tune_epochs || tune_threads) && !tuner_settings.has_value())
+		fruit::fatal_error("--tune-epochs and --tune-threads require --tune <data> <output>");
+	if (tune_epochs)
+		tuner_settings->epoch_count = *tune_epochs;
+	if (tune_threads)
+		tuner_settings->thread_count = *tune_threads;
+}
+
+/// Reads the integer of at least `minimum` that follows the option `arg` at `argv[i]`, and advances `i` past it.
+int parse_count_arg(const std::string &arg, int minimum, int argc, char **argv, int &i)
+{
+	if (i + 1 >= argc)
+		fruit::fatal_error("Missing value for " + arg);
+	i++;
+	const std::string value(argv[i]);
+	size_t length = 0;
+	int count = 0;
+	try {
+		count = std::stoi(value, &length);
+	}
+	catch (const std::exception &) {
+		length = 0;
 	}
+	if (length == 0 || length != value.size() || count < minimum)
+		fruit::fatal_error("Invalid value for " + arg + ": " + fruit::debug_description(value) + " (expected an integer of at least " + std::to_string(minimum) + ")");
+	return count;
 }
 
 void play_game()
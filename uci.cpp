@@ -10,6 +10,7 @@
 #include "hummingbird.h"
 #include "perft.h"
 #include "definitions.h"
+#include <atomic>
 
 // Hummingbird conforms to the UCI protocol as defined in https://backscattering.de/chess/uci/.
 
@@ -19,7 +20,21 @@ namespace UCI
 Variant current_variant = CLASSIC;
 
 bool is_quit = false;
-fruit::DispatchQueue background_queue("com.mckinleykeys.chaos-chess.hummingbird.uci-background-queue");
+
+/// All output goes through this writer so that lines from the input thread and the search thread never interleave. The search writes all `info` lines of an iteration before flushing them together.
+fruit::BufferedWriter output(cout);
+
+/// Sends `message` along with everything that is waiting in `output`.
+void send(const std::string &message)
+{
+	output.write_line(message);
+	output.flush();
+}
+/// Writes `message` to `output` without flushing it, for replies that span several lines.
+void queue(const std::string &message)
+{
+	output.write_line(message);
+}
 
 template<Variant V>
 class Session
@@ -29,26 +44,62 @@ class Session
 	Hummingbird<V> hummingbird;
 	bool should_end_session;
 	
+	/// Runs `go` commands so that the input thread can keep answering commands. Only the input thread starts or joins it.
+	std::thread search_thread;
+	/// Set by the search thread once it has sent its result.
+	std::atomic<bool> search_finished;
+	
 public:
 	
-	Session() : should_end_session(false)
+	Session() : should_end_session(false), search_finished(true)
 	{
 		hummingbird.default_setup();
+		hummingbird.info_output = &output;
+	}
+	~Session()
+	{
+		stop_search();
 	}
 	
 private:
 	
+	/// Starts `task` on the search thread. Any search that is already running is stopped first.
+	void start_search(const std::function<void()> &task)
+	{
+		stop_search();
+		search_finished = false;
+		search_thread = std::thread([task, this]() {
+			task();
+			search_finished = true;
+		});
+	}
+	/// Stops the search thread and waits for it to send its result. Must be called before touching `hummingbird` from the input thread.
+	void stop_search()
+	{
+		if (!search_thread.joinable())
+			return;
+		// The search thread may not have started searching yet, in which case a single stop request would be lost. Keep asking until it finishes.
+		while (!search_finished) {
+			hummingbird.stop_immediately();
+			Perft::stop_requested = true;
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		search_thread.join();
+	}
+	
 	bool has_next_token()
 	{
 		return !line_stream.eof();
 	}
-	std::string next_token()
+	/// Option names and commands are case-insensitive, so tokens are lowercased unless `lowercase` is `false`.
+	std::string next_token(bool lowercase = true)
 	{
 		if (!has_next_token())
 			return "";
 		std::string token;
 		line_stream >> token;
-		token = fruit::to_lowercase(token);
+		if (lowercase)
+			token = fruit::to_lowercase(token);
 		return token;
 	}
 	
@@ -61,19 +112,70 @@ private:
 		if (token != "name")
 			return;
 		
-		token = next_token();
-		if (token == "FiftyMoveRule") {
-			// Consume "value"
-			token = next_token();
-			if (token != "value")
-				return;
-			// Get the value
+		// Option names can be multiple words long
+		std::vector<std::string> name_tokens;
+		while (has_next_token()) {
 			token = next_token();
+			if (token == "value")
+				break;
+			name_tokens.push_back(token);
+		}
+		const std::string name = fruit::join(name_tokens, " ");
+		
+		if (name == "evalfile") {
+			// File paths are case-sensitive and may contain spaces
+			std::vector<std::string> value_tokens;
+			while (has_next_token())
+				value_tokens.push_back(next_token(false));
+			const std::string file_url = fruit::join(value_tokens, " ");
+			if (file_url.empty() || file_url == "<empty>") {
+				NNUE::unload(V);
+				send("Using the hand-written evaluation");
+			}
+			else if (NNUE::load(V, file_url))
+				send("Loaded network " + file_url + " for " + Notation::variant_to_string(V));
+			// Cached evaluations came from the previous evaluation function
+			hummingbird.reset_tables();
+			return;
+		}
+		if (name == "syzygypath") {
+			std::vector<std::string> value_tokens;
+			while (has_next_token())
+				value_tokens.push_back(next_token(false));
+			const int table_count = Syzygy::init(fruit::join(value_tokens, " "));
+			send("Found " + std::to_string(table_count) + " tablebases");
+			if (table_count && !Variants::has_standard_rules(V))
+				send("Tablebases are only used for " + Notation::variant_to_string(CLASSIC));
+			// Scores in the transposition table came from searches without the tables
+			hummingbird.reset_tables();
+			return;
+		}
+		
+		// Get the value
+		token = next_token();
+		
+		if (name == "fiftymoverule") {
 			if (token == "true")
 				hummingbird.game.fifty_move_rule_enabled = true;
 			if (token == "false")
 				hummingbird.game.fifty_move_rule_enabled = false;
 		}
+		else if (name == "move overhead") {
+			try {
+				hummingbird.time_manager.move_overhead = (double)std::clamp(std::stoi(token), 0, 5000) / 1000;
+			}
+			catch (...) {
+				send("Invalid move overhead specified");
+			}
+		}
+		else if (name == "multipv") {
+			try {
+				hummingbird.multi_pv = std::clamp(std::stoi(token), 1, hummingbird.MAX_MULTI_PV);
+			}
+			catch (...) {
+				send("Invalid MultiPV specified");
+			}
+		}
 	}
 	void position()
 	{
@@ -89,7 +191,8 @@ private:
 		else if (token == "fen") {
 			std::string fen = "";
 			while (has_next_token()) {
-				token = next_token();
+				// FEN strings are case-sensitive
+				token = next_token(false);
 				if (token == "moves") break;
 				fen += token + " ";
 			}
@@ -117,10 +220,19 @@ private:
 		std::string token;
 		
 		bool perft = false;
-		int depth_limit = 0;
-		uint64_t node_limit = 0;
-		double move_time_limit = 0;
-		bool infinite = false;
+		SearchLimits limits;
+		
+		// Reads the next token as a number of milliseconds, returning it in seconds
+		auto next_milliseconds = [this](const std::string &name) -> double {
+			const std::string token = next_token();
+			try {
+				return (double)std::stoll(token) / 1000;
+			}
+			catch (...) {
+				send("Invalid " + name + " specified");
+				return 0;
+			}
+		};
 		
 		while (has_next_token()) {
 			
@@ -129,81 +241,98 @@ private:
 			if (token == "depth") {
 				token = next_token();
 				try {
-					depth_limit = std::stoi(token);
+					limits.depth = std::stoi(token);
 				}
 				catch (...) {
-					cout << "Invalid depth limit specified" << endl;
+					send("Invalid depth limit specified");
 				}
 			}
 			else if (token == "nodes") {
 				token = next_token();
 				try {
-					node_limit = std::stoull(token);
+					limits.nodes = std::stoull(token);
 				}
 				catch (...) {
-					cout << "Invalid node limit specified" << endl;
+					send("Invalid node limit specified");
 				}
 			}
-			else if (token == "movetime") {
+			else if (token == "movetime")
+				limits.move_time = next_milliseconds("move time limit");
+			else if (token == "wtime") {
+				limits.time[WHITE] = next_milliseconds("white time");
+				limits.has_time[WHITE] = true;
+			}
+			else if (token == "btime") {
+				limits.time[BLACK] = next_milliseconds("black time");
+				limits.has_time[BLACK] = true;
+			}
+			else if (token == "winc")
+				limits.increment[WHITE] = next_milliseconds("white increment");
+			else if (token == "binc")
+				limits.increment[BLACK] = next_milliseconds("black increment");
+			else if (token == "movestogo") {
 				token = next_token();
 				try {
-					uint64_t milliseconds = std::stoull(token);
-					move_time_limit = (double)milliseconds / 1000;
+					limits.moves_to_go = std::stoi(token);
 				}
-				catch(...) {
-					cout << "Invalid move time limit specified" << endl;
+				catch (...) {
+					send("Invalid moves to go specified");
 				}
 			}
 			else if (token == "perft") {
 				perft = true;
 				token = next_token();
 				try {
-					depth_limit = std::stoi(token);
+					limits.depth = std::stoi(token);
 				}
 				catch (...) {
-					cout << "Invalid depth limit specified" << endl;
+					send("Invalid depth limit specified");
 				}
 			}
 			else if (token == "infinite")
-				infinite = true;
+				limits.infinite = true;
+			else if (token == "ponder")
+				limits.ponder = true;
 		}
 		
 		if (perft) {
+			const int depth_limit = limits.depth;
 			if (depth_limit) {
-				background_queue.async([depth_limit, this]() {
+				start_search([depth_limit, this]() {
 					Perft::table.reset();
 					auto results = Perft::divide(hummingbird.game, depth_limit);
-					cout << endl;
+					if (Perft::stop_requested) {
+						send("info string perft stopped before it finished");
+						return;
+					}
+					std::vector<std::string> lines;
 					for (auto entry : results)
-						cout << entry.first << ": " << entry.second << endl;
-					cout << endl;
+						lines.push_back(entry.first + ": " + std::to_string(entry.second));
+					send(fruit::join(lines, "\n"));
 				});
 			}
 			else {
-				cout << "No depth limit specified for 'perft' command" << endl;
-				cout << endl;
+				send("No depth limit specified for 'perft' command");
 			}
 		}
 		else {
-			if (move_time_limit > 0) {
-				background_queue.async([depth_limit, move_time_limit, this]() {
-					Move move = hummingbird.find_best_move(depth_limit, move_time_limit);
-					cout << "bestmove " << Notation::move_to_string(move) << endl;
-					cout << endl;
-				});
-			}
-			else {
-				background_queue.async([depth_limit, this]() {
-					Move move = hummingbird.find_best_move(depth_limit);
-					cout << "bestmove " << Notation::move_to_string(move) << endl;
-					cout << endl;
-				});
-			}
+			// Stop the previous search before marking the hummingbird as pondering, since stopping clears the flag
+			stop_search();
+			if (limits.ponder)
+				hummingbird.begin_pondering();
+			start_search([limits, this]() {
+				Move move = hummingbird.find_best_move(limits);
+				std::string message = "bestmove " + Notation::move_to_string(move);
+				if (hummingbird.ponder_move != NULL_MOVE)
+					message += " ponder " + Notation::move_to_string(hummingbird.ponder_move);
+				send(message);
+			});
 		}
 	}
 	void ucinewgame()
 	{
-		// Nothing to do
+		// Forget everything from the previous game so that searches don't depend on what came before
+		hummingbird.reset_tables();
 	}
 	void display()
 	{
@@ -214,13 +343,12 @@ private:
 			token = next_token();
 			
 			if (token == "variant") {
-				cout << "<" << Notation::variant_to_string(V) << ">" << endl;
+				send("<" + Notation::variant_to_string(V) + ">");
 				return;
 			}
 		}
 		
-		cout << hummingbird.game.visual() << endl;
-		cout << endl;
+		send(hummingbird.game.visual() + "\n");
 	}
 	void variant()
 	{
@@ -250,7 +378,7 @@ private:
 		Variant new_variant = Notation::parse_variant(name);
 		if (new_variant != UNRECOGNIZED_VARIANT) {
 			current_variant = new_variant;
-			cout << "Changed variant to <" << Notation::variant_to_string(current_variant) << ">" << endl;
+			send("Changed variant to <" + Notation::variant_to_string(current_variant) + ">");
 			should_end_session = true;
 		}
 	}
@@ -268,27 +396,46 @@ private:
 			// MARK: - Standard UCI Commands
 			
 			if (token == "uci") {
-				cout << "id name " << "Hummingbird" << endl;
-				cout << "id author " << "McKinley Keys" << endl;
+				queue("id name Hummingbird");
+				queue("id author McKinley Keys");
 				// Indicate that Hummingbird uses its own opening book by default
-				cout << "option name OwnBook type check default true" << endl;
+				queue("option name OwnBook type check default true");
 				// Indicate that Hummingbird uses the fifty move rule by default
-				cout << "option name FiftyMoveRule type check default true" << endl;
-				cout << "uciok" << endl;
+				queue("option name FiftyMoveRule type check default true");
+				queue("option name Move Overhead type spin default 10 min 0 max 5000");
+				queue("option name MultiPV type spin default 1 min 1 max " + std::to_string(hummingbird.MAX_MULTI_PV));
+				// Indicate that Hummingbird can ponder
+				queue("option name Ponder type check default false");
+				// An empty file selects the hand-written evaluation
+				queue("option name EvalFile type string default <empty>");
+				// Directories with Syzygy tablebases, separated by colons
+				queue("option name SyzygyPath type string default <empty>");
+				send("uciok");
 			}
-			else if (token == "setoption")
+			else if (token == "setoption") {
+				stop_search();
 				setoption();
-			else if (token == "position")
+			}
+			else if (token == "position") {
+				stop_search();
 				position();
+			}
 			else if (token == "go")
 				go();
 			else if (token == "stop")
-				hummingbird.stop_immediately();
-			else if (token == "ucinewgame")
+				stop_search();
+			else if (token == "ponderhit")
+				// The search keeps running, but now under its normal time budget
+				hummingbird.ponderhit();
+			else if (token == "ucinewgame") {
+				stop_search();
 				ucinewgame();
+			}
 			else if (token == "isready")
-				cout << "readyok" << endl;
+				// The input thread never waits on the search, so this is answered immediately even mid-search
+				send("readyok");
 			else if (token == "quit" || token == "q") {
+				stop_search();
 				is_quit = true;
 				should_end_session = true;
 				break;
@@ -296,10 +443,14 @@ private:
 			
 			// MARK: - Custom Commands
 			
-			else if (token == "d")
+			else if (token == "d") {
+				stop_search();
 				display();
-			else if (token == "variant")
+			}
+			else if (token == "variant") {
+				stop_search();
 				variant();
+			}
 			
 			else {
 				// We encountered an unregonized UCI command. As per the specification, we should ignore the token and continue parsing the line.